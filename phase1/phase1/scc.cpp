@@ -5,285 +5,322 @@
  * Due:     7 Apr 2019 at 11:59 PM
  */
 
-#include <cctype>
-#include <fstream>
-#include <iostream>
-#include <set>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <unistd.h>
+#include <vector>
 
-using std::cin;
-using std::cout;
-using std::set;
 using std::size_t;
 using std::string;
+using std::vector;
 
-/* what type of symbol we are currently scanning */
-enum ScannerState {
+/* valid Simple C keywords */
+constexpr const char* keywords[] = {
+  "auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum", "extern",
+  "float", "for", "goto", "if", "int", "long", "register", "return", "short", "signed", "sizeof", "static",
+  "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while"
+};
 
-  /* indeterminate state - nothing has been scanned */
-  undefined,
+/* valid Simple C operators */
+constexpr const char* operators[] = {
+  "=", "|", "||", "&&", "==", "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%", "&", "!", "++", "--", ".",
+  "->", "(", ")", "[", "]", "{", "}", ";", ":", ","
+};
+
+/* what kind of token, if any, the scanner has matched upon reaching a state */
+enum Accept : unsigned char {
+
+  /* nothing has been matched - the state is inside a comment or an unterminated string */
+  none,
 
-  /* currently skipping over a comment */
-  comment,
+  /* a keyword, or an identifier that so far spells a keyword */
+  keyword,
 
-  /* reading an identifier, which may be a keyword instead */
+  /* any other identifier */
   identifier,
 
-  /* reading a normal or long integer */
+  /* a normal integer */
   number,
 
-  /* reading a string literal "" */
-  text
+  /* an integer followed by L or l */
+  long_number,
 
-};
+  /* a complete string literal "" */
+  text,
 
-/* symbols that signal comments */
-const string COMMENT_CLOSE = "*/";
-const string COMMENT_OPEN = "/*";
-const string COMMENT_SINGLE = "//";
+  /* an operator */
+  op
 
-/* valid Simple C keywords */
-const set<string> keywords {
-  "auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum", "extern", 
-  "float", "for", "goto", "if", "int", "long", "register", "return", "short", "signed", "sizeof", "static", 
-  "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while"
 };
 
-/* valid Simple C operators */
-const set<string> operators {
-  "=", "|", "||", "&&", "==", "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%", "&", "!", "++", "--", ".", 
-  "->", "(", ")", "[", "]", "{", "}", ";", ":", ","
+/* output prefix for each kind of token, indexed by Accept */
+const char* const prefixes[] = { "", "keyword:", "identifier:", "int:", "long:", "string:", "operator:" };
+
+/* fixed states of the scanner - the states at or below block_star are between tokens, so no
+  characters are kept for them */
+enum State : unsigned char {
+
+  /* no transition - the token so far is complete */
+  dead,
+
+  /* indeterminate state - nothing has been scanned */
+  start,
+
+  /* skipping over a // comment */
+  line_comment,
+
+  /* skipping over a comment */
+  block_comment,
+
+  /* skipping over a comment, having just seen a * that may close it */
+  block_star,
+
+  /* reading a string literal "" */
+  string_body,
+
+  /* read the closing quote of a string literal */
+  string_end,
+
+  /* reading a normal integer */
+  integer,
+
+  /* read the L or l of a long integer */
+  long_integer,
+
+  /* reading an identifier that cannot be a keyword */
+  plain_identifier,
+
+  /* the remaining states are created while building the automaton */
+  first_built_state
+
 };
 
-/* scan input for each type of Simple C syntax
-  returns true when a match is found with input symbol, false if the input symbol does not fit
-  the conditions of this scan */
-bool scan_comments( char& symbol, char& next_symbol );
-bool scan_strings( char& symbol, char& next_symbol );
-bool scan_numbers( char& symbol, char& next_symbol );
-bool scan_identifiers( char& symbol, char& next_symbol );
-bool scan_keywords( char& symbol, char& next_symbol );
-bool scan_operators( char& symbol, char& next_symbol );
-
-/* returns true when symbol matches L or l, indicating a long int */
-bool is_long( char symbol );
-/* returns true when symbol is a valid identifier character, i.e. underscores and alpha */
-bool is_id( char symbol );
-/* returns a string from one char input */
-string chartos( char symbol );
-
-/* empties the buffer, resets ScannerState to default and prints an output message */
-void reset( string msg = "" );
-/* store a character in the buffer */
-void store( char in );
-/* return the current buffer of characters */
-string stored( );
-/* skip the next character in the buffer, typically after peeking and deciding to toss it */
-void skip_next( );
-/* skip input until first character (c) is found */
-void skip_until( char c );
-
-/* string of increasing size as input is processed, returned to default ScannerState by reset( ) */
-string cache = "";
-ScannerState state = undefined;
+constexpr int MAX_STATES = 256;
+constexpr int MAX_CLASSES = 64;
 
-int main( void ) {
-  char c;
-
-  while (cin.get( c )) {
-    // always store next char in case we need it (likely)
-    char peek = cin.peek( );
-
-    // each method returns true if an item was processed, i.e., ready to move to next char
-    if (scan_comments( c, peek )) continue;
-    if (scan_strings( c, peek )) continue;
-    if (scan_identifiers( c, peek )) continue;
-    if (scan_operators( c, peek )) continue;
-    if (scan_numbers( c, peek )) continue;
+/* deterministic automaton that recognizes every Simple C token, built entirely at compile time from
+  the keyword and operator lists above.  characters are first mapped to classes, where characters the
+  automaton never needs to tell apart share a class, which keeps the transition table small enough to
+  stay in cache */
+struct Automaton {
+
+  /* class of each input character */
+  unsigned char classes[256];
+
+  /* next state given the current state and the class of the next character */
+  unsigned char next[MAX_STATES][MAX_CLASSES];
+
+  /* kind of token matched upon reaching each state */
+  Accept accept[MAX_STATES];
+
+  int num_states;
+  int num_classes;
+
+  constexpr Automaton( ) : classes( ), next( ), accept( ), num_states( first_built_state ), num_classes( 0 ) {
+    build_classes( );
+    build_keywords( );
+    build_operators( );
+    build_fixed( );
   }
 
-  return EXIT_SUCCESS;
-}
+  /* returns true when symbol is a valid identifier character, i.e. underscores and alphanumerics */
+  static constexpr bool is_id( int symbol ) {
+    return symbol == '_' || (symbol >= 'a' && symbol <= 'z') || (symbol >= 'A' && symbol <= 'Z') || is_digit( symbol );
+  }
 
-bool scan_comments( char& symbol, char& symbol_next ) {
-  switch (state) {
-    // (on close */): skip multi-line comments
-    case comment:
-      if (symbol == COMMENT_CLOSE[0] && symbol_next == COMMENT_CLOSE[1]) {
-        reset( );
-        skip_next( );
-      }
+  /* returns true when symbol is a decimal digit */
+  static constexpr bool is_digit( int symbol ) {
+    return symbol >= '0' && symbol <= '9';
+  }
 
-      return true;
+  /* returns true when symbol is white space other than a newline */
+  static constexpr bool is_blank( int symbol ) {
+    return symbol == ' ' || symbol == '\t' || symbol == '\r' || symbol == '\v' || symbol == '\f';
+  }
 
-    default:
-      /* (on open): skip multi-line comments */
-      if (symbol == COMMENT_OPEN[0] && symbol_next == COMMENT_OPEN[1]) 
-        state = comment;
-      /* (on //): skip one-line comments */
-      else if (symbol == COMMENT_SINGLE[0] && symbol_next == COMMENT_SINGLE[1]) 
-        skip_until( '\n' );
-      else return false;
+  /* gives symbol a class of its own, unless it already has one */
+  constexpr void distinguish( int symbol ) {
+    if (classes[symbol] == 0) classes[symbol] = num_classes++;
   }
 
-  return true;
-}
+  /* class 0 is everything we ignore; white space, newlines, quotes, digits and the letters L and l
+    matter on their own, as does every character in a keyword or an operator.  every other identifier
+    character shares one class */
+  constexpr void build_classes( ) {
+    num_classes = 1;
 
-bool scan_strings( char& symbol, char& next_symbol ) {
-  switch (state) {
-    case text:
-      /* reached the end of the string */
-      if (symbol == '"') 
-        reset( "string:\"" + stored( ) + "\"" );
-      /* otherwise continue reading string */
-      else 
-        store( symbol );
+    for (int c = 0; c < 256; c++) if (is_blank( c )) classes[c] = num_classes;
+    num_classes++;
 
-      return true;
+    distinguish( '\n' );
+    distinguish( '"' );
+    distinguish( 'L' );
+    distinguish( 'l' );
 
-    default:
-      // string has been discovered
-      if (symbol == '"') {
-        state = text;
+    for (int c = 0; c < 256; c++) if (is_digit( c )) classes[c] = num_classes;
+    num_classes++;
 
-        return true;
-      }
+    for (const char* keyword : keywords) for (const char* p = keyword; *p; p++) distinguish( *p );
+    for (const char* op : operators) for (const char* p = op; *p; p++) distinguish( *p );
 
-      return false;
+    int other = num_classes++;
+    for (int c = 0; c < 256; c++) if (is_id( c ) && classes[c] == 0) classes[c] = other;
   }
-}
 
-bool scan_numbers( char& symbol, char& next_symbol ) {
-  switch (state) {
-    // continuing to read a number
-    case number:
-      if (isdigit( next_symbol )) return true;
-      /* reached the end of the number */
-      else {
-        store( symbol );
-        
-        if (is_long( next_symbol )) {
-          store( next_symbol );
-          skip_next( );
-        }
-
-        reset( (is_long( next_symbol ) ? "long" : "int") + string(":") + stored( ) );
-        return true; 
-      }
+  /* follows the transition from state on symbol, creating a new state if there is none yet */
+  constexpr int extend( int state, char symbol, Accept kind ) {
+    unsigned char& target = next[state][classes[(unsigned char) symbol]];
 
-    // may find a number 
-    case undefined:
-      /* identify numbers */
-      if (isdigit( symbol )) {
-        store( symbol );
-        state = number;
-
-        // try to identify a one-character long int
-        if (is_long( next_symbol )) {
-          store( next_symbol );
-          skip_next( );
-
-          reset( "long:" + stored( ) );
-          return true;
-        } else if (!isdigit( next_symbol )) {
-          /* or maybe we've matched a one-character int */
-          reset( "int:" + stored( ) );
-          return true;
-        }
-
-        return true;
-      }
+    if (target == dead || target == plain_identifier) {
+      target = num_states++;
+      accept[target] = kind;
+    }
+
+    return target;
   }
 
-  return false;
-}
+  /* keywords form a trie of identifier states, and every identifier character that leaves the trie
+    leads to a plain identifier */
+  constexpr void build_keywords( ) {
+    for (const char* keyword : keywords) {
+      int state = start;
 
-bool scan_identifiers( char& symbol, char& next_symbol ) {
-  switch (state) {
-    // continuining previous identifier
-    case identifier:
-      store( symbol );
-
-      /* peek to make sure we haven't reached the end */
-      if (!is_id( next_symbol )) {
-        // if so, maybe it's a keyword
-        if (keywords.find( stored( ) ) != keywords.end( )) 
-          reset( "keyword:" + stored( ) );
-        // otherwise, just an identifier
-        else reset( "identifier:" + stored( ) );
-
-        return true;
-      }
-      
-      return false;
-
-    // might be an indentifier
-    case undefined:
-      /* note we specifically prevent numbers from being first symbol */
-      if (is_id( symbol ) && !isdigit( symbol )) {
-        // identify continuing (longer than one char) identifier
-        if (is_id( next_symbol )) {
-          store( symbol );
-          state = identifier;
-        } else reset( "identifier:" + chartos( symbol ) );
-
-        return true;
-      }
+      for (const char* p = keyword; *p; p++) state = extend( state, *p, identifier );
+      accept[state] = ::keyword;
+    }
+
+    for (int state = first_built_state; state < num_states; state++)
+      for (int c = 0; c < 256; c++)
+        if (is_id( c ) && next[state][classes[c]] == dead) next[state][classes[c]] = plain_identifier;
   }
 
-  return false;
-}
+  /* operators form a trie as well, and a / followed by / or * starts a comment instead */
+  constexpr void build_operators( ) {
+    for (const char* op : operators) {
+      int state = start;
+
+      for (const char* p = op; *p; p++) state = extend( state, *p, none );
+      accept[state] = Accept::op;
+    }
+
+    int slash = next[start][classes['/']];
+    next[slash][classes['/']] = line_comment;
+    next[slash][classes['*']] = block_comment;
+  }
 
-bool scan_operators( char& symbol, char& next_symbol ) {
-  /* try to find this symbol in the operators table */
-  if (operators.find( chartos( symbol ) ) != operators.end()) {
-    store( symbol );
+  /* everything else: white space, comments, strings, numbers and identifiers */
+  constexpr void build_fixed( ) {
+    for (int k = 0; k < num_classes; k++) {
+      if (next[start][k] == dead) next[start][k] = start;
+      next[line_comment][k] = line_comment;
+      next[block_comment][k] = block_comment;
+      next[block_star][k] = block_comment;
+      next[string_body][k] = string_body;
+    }
 
-    // try to match the next character as well, identifying operators like &&
-    string match = chartos( symbol ) + chartos( next_symbol );
-    if (operators.find( match ) != operators.end()) {
-      store( next_symbol );
-      skip_next( );
+    for (int c = 0; c < 256; c++) {
+      if (is_id( c )) next[plain_identifier][classes[c]] = plain_identifier;
+      if (is_id( c ) && !is_digit( c ) && next[start][classes[c]] == start)
+        next[start][classes[c]] = plain_identifier;
     }
 
-    reset( "operator:" + stored( ) );
-    return true;
+    next[start][classes['"']] = string_body;
+    next[start][classes['0']] = integer;
+    next[line_comment][classes['\n']] = start;
+    next[block_comment][classes['*']] = block_star;
+    next[block_star][classes['*']] = block_star;
+    next[block_star][classes['/']] = start;
+    next[string_body][classes['"']] = string_end;
+    next[integer][classes['0']] = integer;
+    next[integer][classes['L']] = long_integer;
+    next[integer][classes['l']] = long_integer;
+
+    accept[string_end] = text;
+    accept[integer] = number;
+    accept[long_integer] = long_number;
+    accept[plain_identifier] = identifier;
   }
+};
 
-  return false;
-}
+constexpr Automaton automaton;
 
-bool is_long( char symbol ) {
-  return symbol == 'L' || symbol == 'l';
-}
+static_assert(automaton.num_states <= MAX_STATES, "too many scanner states");
+static_assert(automaton.num_classes <= MAX_CLASSES, "too many character classes");
 
-bool is_id( char symbol ) {
-  return isalpha( symbol ) || isdigit( symbol ) || symbol == '_';
-}
+/* size of the first input buffer, which grows only if a single token is larger than half of it */
+constexpr size_t BUFFER_SIZE = 1 << 20;
 
-string chartos( char symbol ) {
-  return string( 1, symbol );
-}
+/* tokens are written here and flushed in large blocks */
+string output;
 
-void reset( string msg ) {
-  cache = "";
-  state = undefined;
+/* appends a token of the given kind to the output, flushing it when it gets large */
+void emit( Accept kind, const char* symbols, size_t length );
+/* writes any remaining output */
+void flush( );
 
-  if (msg.length() > 1) cout << msg << "\n";
-}
+int main( void ) {
+  vector<char> buffer( BUFFER_SIZE );
+  size_t begin = 0, pos = 0, end = 0;
+  int state = start;
 
-void store( char in ) {
-  cache += in;
-}
+  while (true) {
+    // keep only the token in progress, then read more input after it
+    if (pos == end) {
+      size_t keep = end - begin;
+
+      if (keep > buffer.size( ) / 2) buffer.resize( buffer.size( ) * 2 );
+
+      memmove( buffer.data( ), buffer.data( ) + begin, keep );
+      pos -= begin;
+      begin = 0;
+      end = keep;
+
+      ssize_t count = read( 0, buffer.data( ) + end, buffer.size( ) - end );
+      if (count <= 0) break;
+
+      end += count;
+    }
+
+    const char* symbols = buffer.data( );
+
+    while (pos < end) {
+      int target = automaton.next[state][automaton.classes[(unsigned char) symbols[pos]]];
 
-string stored( ) {
-  return cache;
+      /* no transition: the token is complete, and this character starts the next one */
+      if (target == dead) {
+        emit( automaton.accept[state], symbols + begin, pos - begin );
+        state = start;
+        begin = pos;
+        continue;
+      }
+
+      state = target;
+      pos++;
+
+      // between tokens, nothing needs to be kept
+      if (state <= block_star) begin = pos;
+    }
+  }
+
+  emit( automaton.accept[state], buffer.data( ) + begin, pos - begin );
+  flush( );
+
+  return EXIT_SUCCESS;
 }
 
-void skip_next() {
-  cin.ignore(1);
+void emit( Accept kind, const char* symbols, size_t length ) {
+  if (kind == none) return;
+
+  output += prefixes[kind];
+  output.append( symbols, length );
+  output += '\n';
+
+  if (output.size( ) > BUFFER_SIZE) flush( );
 }
 
-void skip_until( char c ) {
-  cin.ignore(256, c);
+void flush( ) {
+  fwrite( output.data( ), 1, output.size( ), stdout );
+  output.clear( );
 }
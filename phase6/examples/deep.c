@@ -0,0 +1,262 @@
+/* deep.c */
+
+int printf();
+
+int inc(int x)
+{
+    return x + 1;
+}
+
+/*
+ * expressions nested thousands deep
+ */
+
+int main(void)
+{
+    int x, y;
+
+    x = 3;
+    y =
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + ( x + (
+        x
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) );
+    printf("%d\n", y);
+
+    y =
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc( inc(
+        inc( inc( inc( inc( inc( inc( inc( inc(
+        0
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) )
+        ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) );
+    printf("%d\n", y);
+}
@@ -0,0 +1,29 @@
+/* divide.c */
+
+int printf();
+
+int f(int a, int b, int c, int d, int e, int g)
+{
+    return a + b * 2 + c * 3 + d * 5 + e * 7 + g * 11;
+}
+
+/*
+ * divide by constants in call arguments while every register is in use
+ */
+
+int g(int a, int b, int x, int y)
+{
+    return f(x * y, a - b, (a + 3) / -2 % 5, (x + y) % -16 / 8, a / 5, b % -7);
+}
+
+int main(void)
+{
+    int i;
+
+    i = -20;
+
+    while (i <= 20) {
+        printf("%d\n", g(i * 7, i - 96, i * 13 + 98, 48 - i));
+        i = i + 1;
+    }
+}
@@ -0,0 +1,227 @@
+/*
+ * File:	Atom.cpp
+ *
+ * Description:	This file contains the member function definitions for
+ *		atoms in Simple C.
+ *
+ *		The atom table is an open-addressing hash table of indices
+ *		into a list of spellings.  The spellings are kept in a
+ *		deque so that a reference to one is never invalidated by
+ *		interning another.  Interning from a pointer and length
+ *		means the lexer's views can be interned without first
+ *		building a string.
+ */
+
+# include <deque>
+# include <vector>
+# include <cstring>
+# include "Atom.h"
+
+using namespace std;
+
+struct AtomTable {
+    deque<string> spellings;
+    vector<unsigned> slots;
+
+    AtomTable();
+    unsigned intern(const char *text, unsigned length);
+};
+
+
+/*
+ * Function:	hashString (private)
+ *
+ * Description:	Return the FNV-1a hash of the given characters.
+ */
+
+static unsigned hashString(const char *text, unsigned length)
+{
+    unsigned h = 2166136261u;
+
+    for (unsigned i = 0; i < length; i ++)
+	h = (h ^ (unsigned char) text[i]) * 16777619u;
+
+    return h;
+}
+
+
+/*
+ * Function:	AtomTable::AtomTable (constructor)
+ *
+ * Description:	Initialize the table with the atoms that are available as
+ *		constants, in the same order as they are numbered.
+ */
+
+AtomTable::AtomTable()
+    : slots(256, 0)
+{
+    intern("error", 5);
+    intern("int", 3);
+    intern("long", 4);
+    intern("char", 4);
+}
+
+
+/*
+ * Function:	AtomTable::intern
+ *
+ * Description:	Return the index of the given string, adding it to the
+ *		table if it isn't already there.  A slot holds one more
+ *		than the index, so that zero means the slot is empty.  The
+ *		table is doubled whenever it becomes half full.
+ */
+
+unsigned AtomTable::intern(const char *text, unsigned length)
+{
+    unsigned mask = slots.size() - 1;
+    unsigned i = hashString(text, length) & mask;
+
+
+    while (slots[i] != 0) {
+	const string &s = spellings[slots[i] - 1];
+
+	if (s.size() == length && memcmp(s.data(), text, length) == 0)
+	    return slots[i] - 1;
+
+	i = (i + 1) & mask;
+    }
+
+    spellings.push_back(string(text, length));
+    slots[i] = spellings.size();
+
+    if (spellings.size() * 2 > slots.size()) {
+	vector<unsigned> old(slots.size() * 2, 0);
+
+	old.swap(slots);
+	mask = slots.size() - 1;
+
+	for (unsigned j = 0; j < old.size(); j ++)
+	    if (old[j] != 0) {
+		const string &s = spellings[old[j] - 1];
+
+		for (i = hashString(s.data(), s.size()) & mask; slots[i] != 0; )
+		    i = (i + 1) & mask;
+
+		slots[i] = old[j];
+	    }
+    }
+
+    return spellings.size() - 1;
+}
+
+
+/*
+ * Function:	table (private)
+ *
+ * Description:	Return the atom table, creating it on first use, since
+ *		atoms may be created during static initialization.  Each
+ *		thread has a table of its own, so interning never needs a
+ *		lock.  The predefined atoms are the same in every table,
+ *		but any other atom is meaningful only on the thread that
+ *		created it, which is fine since a program is compiled
+ *		entirely on one thread.
+ */
+
+static AtomTable &table()
+{
+    static thread_local AtomTable atoms;
+    return atoms;
+}
+
+
+/*
+ * Function:	Atom::Atom (constructor)
+ *
+ * Description:	Initialize this atom by interning the given string.
+ */
+
+Atom::Atom(const string &s)
+    : _index(table().intern(s.data(), s.size()))
+{
+}
+
+
+/*
+ * Function:	Atom::Atom (constructor)
+ *
+ * Description:	Initialize this atom by interning the given characters.
+ */
+
+Atom::Atom(const char *text, unsigned length)
+    : _index(table().intern(text, length))
+{
+}
+
+
+/*
+ * Function:	Atom::operator ==
+ *
+ * Description:	Return whether another atom is equal to this atom.
+ */
+
+bool Atom::operator ==(const Atom &rhs) const
+{
+    return _index == rhs._index;
+}
+
+
+/*
+ * Function:	Atom::operator !=
+ *
+ * Description:	Return whether another atom differs from this atom.
+ */
+
+bool Atom::operator !=(const Atom &rhs) const
+{
+    return _index != rhs._index;
+}
+
+
+/*
+ * Function:	Atom::operator <
+ *
+ * Description:	Order atoms by their index, so they can be used as keys.
+ *		This ordering has nothing to do with their spellings.
+ */
+
+bool Atom::operator <(const Atom &rhs) const
+{
+    return _index < rhs._index;
+}
+
+
+/*
+ * Function:	Atom::index (accessor)
+ *
+ * Description:	Return the index of this atom.  Indices are small and
+ *		dense, so they can be used to index a table.
+ */
+
+unsigned Atom::index() const
+{
+    return _index;
+}
+
+
+/*
+ * Function:	Atom::str (accessor)
+ *
+ * Description:	Return the string of this atom.
+ */
+
+const string &Atom::str() const
+{
+    return table().spellings[_index];
+}
+
+
+/*
+ * Function:	operator <<
+ *
+ * Description:	Write an atom to the specified output stream.
+ */
+
+ostream &operator <<(ostream &ostr, const Atom &atom)
+{
+    return ostr << atom.str();
+}
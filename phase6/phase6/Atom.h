@@ -0,0 +1,43 @@
+/*
+ * File:	Atom.h
+ *
+ * Description:	This file contains the class definition for atoms in
+ *		Simple C.  An atom is a small handle for an interned
+ *		string, such as an identifier or a type specifier.  Every
+ *		distinct string is interned exactly once, so two atoms are
+ *		equal exactly when their strings are equal, and comparing
+ *		them is a single integer comparison.
+ *
+ *		A few atoms are so common that they are interned before
+ *		anything else and are available as constants.  That is the
+ *		only reason the constructor from an index is public, and
+ *		why it is defined here rather than in Atom.cpp.
+ */
+
+# ifndef ATOM_H
+# define ATOM_H
+# include <string>
+# include <ostream>
+
+class Atom {
+    typedef std::string string;
+    unsigned _index;
+
+public:
+    constexpr explicit Atom(unsigned index) : _index(index) {}
+    explicit Atom(const string &s);
+    Atom(const char *text, unsigned length);
+
+    bool operator ==(const Atom &rhs) const;
+    bool operator !=(const Atom &rhs) const;
+    bool operator <(const Atom &rhs) const;
+
+    unsigned index() const;
+    const string &str() const;
+};
+
+std::ostream &operator <<(std::ostream &ostr, const Atom &atom);
+
+constexpr Atom errorAtom(0), intAtom(1), longAtom(2), charAtom(3);
+
+# endif /* ATOM_H */
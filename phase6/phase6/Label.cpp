@@ -5,13 +5,18 @@
 
 using std::ostream;
 
-unsigned Label::_counter = 0;
+thread_local unsigned Label::_counter = 0;
 
 Label::Label()
 {
     _number = _counter ++;
 }
 
+void Label::reset()
+{
+    _counter = 0;
+}
+
 unsigned Label::number() const
 {
     return _number;
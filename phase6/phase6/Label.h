@@ -4,11 +4,12 @@
 # include <iostream>
 
 class Label {
-    static unsigned _counter;
+    static thread_local unsigned _counter;
     unsigned _number;
 
 public:
     Label();
+    static void reset();
     unsigned number() const;
 };
 
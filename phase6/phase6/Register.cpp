@@ -18,7 +18,8 @@ using namespace std;
  */
 
 Register::Register(const string &qword, const string &lword, const string &byte)
-    : _qword(qword), _lword(lword), _byte(byte), _node(nullptr)
+    : _qword(qword), _lword(lword), _byte(byte), _node(),
+      _defined(0)
 {
 }
 
@@ -64,8 +65,8 @@ const string& Register::as_byte() const
 
 ostream &operator <<(ostream &ostr, const Register *reg)
 {
-    if (reg->_node != nullptr)
-	return ostr << reg->name(reg->_node->type().size());
+    if (reg->_node)
+	return ostr << reg->name(reg->_node.type().size());
 
     return ostr << reg->name();
 }
@@ -8,12 +8,17 @@
  *		long word (since a word is historically 16-bits), and a
  *		64-bit quad word.  By default, the 64-bit quad word name
  *		will be used.
+ *
+ *		A register in use knows the expression whose value it
+ *		holds, and the position in the code of the function at
+ *		which that value was defined.
  */
 
 # ifndef REGISTER_H
 # define REGISTER_H
 # include <string>
 # include <ostream>
+# include "Tree.h"
 
 class Register {
     typedef std::string string;
@@ -22,7 +27,8 @@ class Register {
     string _byte;
 
 public:
-    class Expression *_node;
+    Node _node;
+    unsigned _defined;
 
     Register(const string &qword, const string &lword, const string &byte);
     const string &name(unsigned size = 0) const;
@@ -9,6 +9,12 @@
  *		yourself.  Besides, it's possible that they're hanging
  *		around other places, like abstract syntax trees.
  *
+ *		Each slot of the hash table is either zero, if empty, or
+ *		one more than the position of a symbol in the list.  Atoms
+ *		are numbered consecutively, so we hash an atom by
+ *		multiplying its index by a large odd constant, which
+ *		scatters neighboring atoms, and then using the high bits.
+ *
  *		Extra functionality:
  *		- retrieving the vector of symbols
  */
@@ -16,6 +22,35 @@
 # include <cassert>
 # include "Scope.h"
 
+# define MAX_LINEAR 8
+# define MIN_SLOTS 32
+
+
+/*
+ * Function:	hashAtom (private)
+ *
+ * Description:	Return the slot at which to start probing for the given
+ *		atom in a table with 2^bits slots.
+ */
+
+static unsigned hashAtom(const Atom &name, unsigned bits)
+{
+    return (name.index() * 2654435769u) >> (32 - bits);
+}
+
+
+/*
+ * Function:	bitsFor (private)
+ *
+ * Description:	Return the base two logarithm of the number of slots in a
+ *		table, which is always a power of two.
+ */
+
+static unsigned bitsFor(unsigned size)
+{
+    return __builtin_ctz(size);
+}
+
 
 /*
  * Function:	Scope::Scope (constructor)
@@ -41,6 +76,94 @@ void Scope::insert(Symbol *symbol)
 {
     assert(find(symbol->name()) == nullptr);
     _symbols.push_back(symbol);
+
+    if (_symbols.size() > MAX_LINEAR) {
+	if (2 * _symbols.size() > _slots.size())
+	    rehash();
+	else
+	    place(_symbols.size() - 1);
+    }
+}
+
+
+/*
+ * Function:	Scope::place (private)
+ *
+ * Description:	Enter the symbol at the given position of the list into
+ *		the hash table, which must have an empty slot.
+ */
+
+void Scope::place(unsigned position)
+{
+    unsigned bits = bitsFor(_slots.size());
+    unsigned mask = _slots.size() - 1;
+    unsigned i = hashAtom(_symbols[position]->name(), bits);
+
+
+    while (_slots[i] != 0)
+	i = (i + 1) & mask;
+
+    _slots[i] = position + 1;
+}
+
+
+/*
+ * Function:	Scope::rehash (private)
+ *
+ * Description:	Rebuild the hash table from the list of symbols, making it
+ *		large enough to be at most half full.  A scope small enough
+ *		to search in order has no table at all.
+ */
+
+void Scope::rehash()
+{
+    unsigned size = MIN_SLOTS;
+
+
+    _slots.clear();
+
+    if (_symbols.size() <= MAX_LINEAR)
+	return;
+
+    while (size < 2 * _symbols.size())
+	size *= 2;
+
+    _slots.resize(size);
+
+    for (unsigned i = 0; i < _symbols.size(); i ++)
+	place(i);
+}
+
+
+/*
+ * Function:	Scope::locate (private)
+ *
+ * Description:	Return one more than the position in the list of the
+ *		symbol with the given name in this scope, or zero if no
+ *		such symbol is found.
+ */
+
+unsigned Scope::locate(const Atom &name) const
+{
+    unsigned i, mask;
+
+
+    if (_slots.empty()) {
+	for (i = 0; i < _symbols.size(); i ++)
+	    if (name == _symbols[i]->name())
+		return i + 1;
+
+	return 0;
+    }
+
+    mask = _slots.size() - 1;
+
+    for (i = hashAtom(name, bitsFor(_slots.size())); _slots[i] != 0;
+	    i = (i + 1) & mask)
+	if (name == _symbols[_slots[i] - 1]->name())
+	    return _slots[i];
+
+    return 0;
 }
 
 
@@ -51,29 +174,31 @@ void Scope::insert(Symbol *symbol)
  *		scope.  If no such symbol is found, return a null pointer.
  */
 
-Symbol *Scope::find(const string &name) const
+Symbol *Scope::find(const Atom &name) const
 {
-    for (unsigned i = 0; i < _symbols.size(); i ++)
-	if (name == _symbols[i]->name())
-	    return _symbols[i];
+    unsigned position = locate(name);
 
-    return nullptr;
+    return position != 0 ? _symbols[position - 1] : nullptr;
 }
 
 
 /*
- * Function:	Scope::remove
+ * Function:	Scope::replace
  *
- * Description:	Remove the symbol with the given name from this scope.
- *		Yes, I know, I duplicated the search logic from above.
- *		And, yes, I still didn't use an iterator.  So sue me.
+ * Description:	Replace the symbol with the same name as the given symbol
+ *		in this scope by the given symbol, which takes its place in
+ *		the list.  It had better already be there.  This happens
+ *		whenever a function declaration is replaced by its
+ *		definition, so neither the list nor the hash table is
+ *		rebuilt.
  */
 
-void Scope::remove(const string &name)
+void Scope::replace(Symbol *symbol)
 {
-    for (unsigned i = 0; i < _symbols.size(); i ++)
-	if (name == _symbols[i]->name())
-	    _symbols.erase(_symbols.begin() + i);
+    unsigned position = locate(symbol->name());
+
+    assert(position != 0);
+    _symbols[position - 1] = symbol;
 }
 
 
@@ -86,15 +211,17 @@ void Scope::remove(const string &name)
  *		null pointer.
  */
 
-Symbol *Scope::lookup(const string &name) const
+Symbol *Scope::lookup(const Atom &name) const
 {
+    const Scope *scope;
     Symbol *symbol;
 
 
-    if ((symbol = find(name)) != nullptr)
-	return symbol;
+    for (scope = this; scope != nullptr; scope = scope->_enclosing)
+	if ((symbol = scope->find(name)) != nullptr)
+	    return symbol;
 
-    return _enclosing != nullptr ? _enclosing->lookup(name) : nullptr;
+    return nullptr;
 }
 
 
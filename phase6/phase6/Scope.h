@@ -2,39 +2,46 @@
  * File:	Scope.h
  *
  * Description:	This file contains the class definition for scopes in
- *		Simple C.  A scope consists simply of a list of symbols.
- *		We use a vector rather than a map because we want to keep
- *		the symbols in insertion order, and we expect the number of
- *		symbols inserted to be small.
+ *		Simple C.  A scope consists of a list of symbols, kept in a
+ *		vector because we want to keep the symbols in insertion
+ *		order.  Most scopes are small and are simply searched in
+ *		order, but once a scope becomes large (say, the outermost
+ *		scope of a generated program with thousands of globals),
+ *		an open-addressing hash table of positions in the list is
+ *		built alongside it and used instead.
  *
  *		Each scope has a link to its enclosing scope.  By
  *		convention, a null scope is used if there is no enclosing
  *		scope.  The find function searches only the given scope,
  *		whereas the lookup function searches the given scope and
- *		all enclosing scopes.
+ *		all enclosing scopes.  Symbols are found by the atom for
+ *		their name, so each comparison is of integers and not of
+ *		strings.
  */
 
 # ifndef SCOPE_H
 # define SCOPE_H
 # include "Symbol.h"
-# include <string>
 # include <vector>
 
 typedef std::vector<Symbol *> Symbols;
 
 class Scope {
-    typedef std::string string;
-
     Scope *_enclosing;
     Symbols _symbols;
+    std::vector<unsigned> _slots;
+
+    void place(unsigned position);
+    void rehash();
+    unsigned locate(const Atom &name) const;
 
 public:
     Scope(Scope *enclosing = nullptr);
 
     void insert(Symbol *symbol);
-    void remove(const string &name);
-    Symbol *find(const string &name) const;
-    Symbol *lookup(const string &name) const;
+    void replace(Symbol *symbol);
+    Symbol *find(const Atom &name) const;
+    Symbol *lookup(const Atom &name) const;
 
     Scope *enclosing() const;
     const Symbols &symbols() const;
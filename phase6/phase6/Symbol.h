@@ -4,23 +4,29 @@
  * Description:	This file contains the class definition for symbols in
  *		Simple C.  At this point, a symbol merely consists of a
  *		name and a type, neither of which you can change.
+ *
+ *		A variable whose address is never taken may be kept in a
+ *		register for its whole lifetime instead of in memory, so
+ *		we count its uses and note whether it escapes.
  */
 
 # ifndef SYMBOL_H
 # define SYMBOL_H
-# include <string>
+# include "Atom.h"
 # include "Type.h"
 
 class Symbol {
-    typedef std::string string;
-    string _name;
+    Atom _name;
     Type _type;
 
 public:
     int _offset;
+    class Register *_register;
+    unsigned _uses;
+    bool _escapes;
 
-    Symbol(const string &name, const Type &type);
-    const string &name() const;
+    Symbol(const Atom &name, const Type &type);
+    const Atom &name() const;
     const Type &type() const;
 };
 
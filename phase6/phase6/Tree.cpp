@@ -1,19 +1,25 @@
 /*
  * File:	Tree.cpp
  *
- * Description:	This file contains the constructor and accessor member
- *		function definitions for abstract syntax trees in Simple C.
+ * Description:	This file contains the constructor and accessor function
+ *		definitions for abstract syntax trees in Simple C.
  *
  *		The tree is actually built during semantic checking, where
  *		type information is readily available.  Any simplifications
  *		or canonicalizations of the tree are performed when it is
  *		constructed.
  *
- *		The functions here are just the constructors and accessors.
- *		The storage allocation and code generation functions are
- *		located elsewhere.  Most of these functions don't do
- *		anything interesting, and could easily be put in the header
- *		file, but we don't like to do that.
+ *		The functions here are just the constructors and the few
+ *		accessors that are not simple enough to be in the header
+ *		file.  The storage allocation and code generation functions
+ *		are located elsewhere.
+ *
+ *		The records of a function are appended to the pool in the
+ *		order in which they are created, which is postorder, so a
+ *		pass that walks the tree mostly moves forward through
+ *		memory.  The arrays of the pool are kept when it is emptied,
+ *		so after the first few functions creating a node allocates
+ *		no memory at all.
  *
  *		Extra functionality:
  *		- everything (it is optional to construct an AST)
@@ -21,552 +27,505 @@
 
 # include "Tree.h"
 
-# include <sstream>
+# include <climits>
 # include <cstdlib>
 
 using namespace std;
 
+thread_local NodePool *pool;
+
 
 /*
- * Function:	Expression::Expression (constructor)
+ * Function:	NodePool::NodePool (constructor)
  *
- * Description:	Initialize the expression object to not be an lvalue and to
- *		have the specified type.
+ * Description:	Initialize an empty pool and make it the pool of this
+ *		thread.
  */
 
-Expression::Expression(const Type &type)
-    : _type(type), _lvalue(false), _offset(0), _register(nullptr)
+NodePool::NodePool()
 {
+    pool = this;
+    clear();
 }
 
 
 /*
- * Function:	Expression::type (accessor)
+ * Function:	NodePool::~NodePool (destructor)
  *
- * Description:	Return the type of this expression.
+ * Description:	Destroy any nodes left in the pool.
  */
 
-const Type &Expression::type() const
+NodePool::~NodePool()
 {
-    return _type;
+    clear();
+    pool = nullptr;
 }
 
 
 /*
- * Function:	Expression::lvalue (accessor)
+ * Function:	NodePool::clear
  *
- * Description:	Return whether this expression is an lvalue.
+ * Description:	Destroy every node in the pool, along with the scope of
+ *		every block and the symbols in it, which nothing refers to
+ *		once the block is gone.  The unused first record is put
+ *		back.
  */
 
-const bool Expression::lvalue() const
+void NodePool::clear()
 {
-    return _lvalue;
-}
-
+    for (unsigned i = 0; i < scopes.size(); i ++) {
+	const Symbols &decls = scopes[i]->symbols();
 
-/*
- * Function:	Binary::Binary (constructor)
- *
- * Description:	Initialize this expression as a binary operator with the
- *		specified children.
- */
+	for (unsigned j = 0; j < decls.size(); j ++)
+	    delete decls[j];
 
-Binary::Binary(Expression *left, Expression *right, const Type &type)
-    : Expression(type), _left(left), _right(right)
-{
-    _hasCall = left->_hasCall | right->_hasCall;
-}
+	delete scopes[i];
+    }
 
+    records.clear();
+    types.clear();
+    registers.clear();
+    offsets.clear();
 
-/*
- * Function:	Unary::Unary (constructor)
- *
- * Description:	Initialize this expression as a unary operator with the
- *		specified child.
- */
+    symbols.clear();
+    scopes.clear();
+    strings.clear();
+    lists.clear();
 
-Unary::Unary(Expression *expr, const Type &type)
-    : Expression(type), _expr(expr)
-{
-    _hasCall = expr->_hasCall;
+    records.push_back(Record());
+    types.push_back(Type());
+    registers.push_back(nullptr);
+    offsets.push_back(0);
 }
 
 
 /*
- * Function:	String::String (constructor)
+ * Function:	table (private)
  *
- * Description:	Initialize this string literal.  We don't care about the
- *		length of the string, only that it is an array.
+ * Description:	Return the pool of nodes for this thread.  The pool is
+ *		constructed on first use, and from then on is reached
+ *		through the plain pointer that its constructor sets.
  */
 
-String::String(const string &value)
-    : Expression(Type("char", 0, 1)), _value(value)
+static NodePool &table()
 {
+    static thread_local NodePool nodes;
+    return nodes;
 }
 
 
 /*
- * Function:	String::value (accessor)
+ * Function:	Node::release
  *
- * Description:	Return the value of this string.
+ * Description:	Destroy every node created since the last release.
  */
 
-const string &String::value() const
+void Node::release()
 {
-    return _value;
+    table().clear();
 }
 
 
 /*
- * Function:	Identifier::Identifier (constructor)
+ * Function:	Node::create (private)
  *
- * Description:	Initialize this identifier object.  An identifier is an
- *		lvalue if its type is a simple type.
+ * Description:	Append a record of the given kind and type to the pool.
+ *		The node is not an lvalue, has no call, and needs one
+ *		register, until the caller says otherwise.
  */
 
-Identifier::Identifier(const Symbol *symbol)
-    : Expression(symbol->type()), _symbol(symbol)
+Node Node::create(Kind kind, const Type &type)
 {
-    _lvalue = symbol->type().isSimple();
-}
+    NodePool::Record r = {kind, 1, false, false, {0, 0, 0}};
+    NodePool &nodes = table();
 
 
-/*
- * Function:	Identifier::symbol (accessor)
- *
- * Description:	Return the symbol of this identifier.
- */
+    nodes.records.push_back(r);
+    nodes.types.push_back(type);
+    nodes.registers.push_back(nullptr);
+    nodes.offsets.push_back(0);
 
-const Symbol *Identifier::symbol() const
-{
-    return _symbol;
+    return Node(nodes.records.size() - 1);
 }
 
 
 /*
- * Function:	Number::Number (constructor)
+ * Function:	Node::String (constructor)
  *
- * Description:	Initialize a number, which has type int or long.
+ * Description:	Create a string literal.  We don't care about the length
+ *		of the string, only that it is an array.
  */
 
-Number::Number(const string &value)
-    : Expression(Type("int")), _value(value)
+Node Node::String(const string &value)
 {
-    unsigned long val;
-    char *ptr;
+    Node node = create(STRING, Type(charAtom, 0, 1));
 
 
-    val = strtoul(value.c_str(), &ptr, 0);
-
-    if (*ptr == 'l' || *ptr == 'L' || (unsigned) val != val)
-	_type = Type("long");
-
-    if (*ptr == 'l' || *ptr == 'L')
-	_value.erase(_value.size() - 1);
+    pool->records[node._index].field[0] = pool->strings.size();
+    pool->strings.push_back(value);
+    return node;
 }
 
 
 /*
- * Function:	Number::Number (constructor)
+ * Function:	Node::Identifier (constructor)
  *
- * Description:	Initialize a number, which always has type long.
+ * Description:	Create an identifier.  An identifier is an lvalue if its
+ *		type is a simple type.  Each identifier counts as a use of
+ *		its symbol.
  */
 
-Number::Number(unsigned long value)
-    : Expression(Type("long"))
+Node Node::Identifier(Symbol *symbol)
 {
-    stringstream ss;
-
-    ss << value;
-    _value = ss.str();
-}
+    Node node = create(IDENTIFIER, symbol->type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Number::value (accessor)
- *
- * Description:	Return the value of this number.
- */
-
-const string &Number::value() const
-{
-    return _value;
+    r.lvalue = symbol->type().isSimple();
+    r.field[0] = pool->symbols.size();
+    pool->symbols.push_back(symbol);
+    symbol->_uses ++;
+    return node;
 }
 
 
 /*
- * Function:	Call::Call (constructor)
+ * Function:	Node::Number (constructor)
  *
- * Description:	Initialize a function call expression.
+ * Description:	Create a number from its lexeme, which has type int or
+ *		long.
  */
 
-Call::Call(const Symbol *id, const Expressions &args, const Type &type)
-    : Expression(type), _id(id), _args(args)
+Node Node::Number(const string &value)
 {
-    _hasCall = true;
-}
+    unsigned long n;
+    char *ptr;
+    Node node;
 
 
-/*
- * Function:	Field::Field (constructor)
- *
- * Description:	Initialize a field reference expression.
- */
+    n = strtoul(value.c_str(), &ptr, 0);
 
-Field::Field(Expression *expr, Symbol *id, const Type &type)
-    : Expression(type), _expr(expr), _id(id)
-{
-    _lvalue = expr->lvalue() && !id->type().isArray();
+    if (*ptr == 'l' || *ptr == 'L' || (unsigned) n != n)
+	node = create(NUMBER, Type(longAtom));
+    else
+	node = create(NUMBER, Type(intAtom));
+
+    pool->records[node._index].field[0] = n;
+    pool->records[node._index].field[1] = n >> 32;
+    return node;
 }
 
 
 /*
- * Function:	Not::Not (constructor)
+ * Function:	Node::Number (constructor)
  *
- * Description:	Initialize a logical negation expression.
+ * Description:	Create a number, which always has type long.
  */
 
-Not::Not(Expression *expr, const Type &type)
-    : Unary(expr, type)
+Node Node::Number(unsigned long value)
 {
-}
-
+    Node node = create(NUMBER, Type(longAtom));
 
-/*
- * Function:	Negate::Negate (constructor)
- *
- * Description:	Initialize an arithmetic negation expression.
- */
 
-Negate::Negate(Expression *expr, const Type &type)
-    : Unary(expr, type)
-{
+    pool->records[node._index].field[0] = value;
+    pool->records[node._index].field[1] = value >> 32;
+    return node;
 }
 
 
 /*
- * Function:	Dereference::Dereference (constructor)
+ * Function:	Node::Call (constructor)
  *
- * Description:	Initialize a dereference expression.
+ * Description:	Create a function call expression.  Its arguments are
+ *		copied to the end of the lists of the pool.
  */
 
-Dereference::Dereference(Expression *expr, const Type &type)
-    : Unary(expr, type)
+Node Node::Call(Symbol *id, const Expressions &args, const Type &type)
 {
-    _lvalue = true;
-}
+    Node node = create(CALL, type);
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Address::Address (constructor)
- *
- * Description:	Initialize an address expression.
- */
+    r.hasCall = true;
+    r.field[0] = pool->symbols.size();
+    r.field[1] = pool->lists.size();
+    r.field[2] = args.size();
 
-Address::Address(Expression *expr, const Type &type)
-    : Unary(expr, type)
-{
+    pool->symbols.push_back(id);
+    pool->lists.insert(pool->lists.end(), args.begin(), args.end());
+    return node;
 }
 
 
 /*
- * Function:	Cast::Cast (constructor)
+ * Function:	Node::Field (constructor)
  *
- * Description:	Initialize a cast expression.
+ * Description:	Create a field reference expression.
  */
 
-Cast::Cast(Expression *expr, const Type &type)
-    : Unary(expr, type)
+Node Node::Field(Node expr, Symbol *id, const Type &type)
 {
-}
+    Node node = create(FIELD, type);
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Multiply::Multiply (constructor)
- *
- * Description:	Initialize a multiplication expression.
- */
+    r.hasCall = expr.hasCall();
+    r.need = expr.need();
+    r.lvalue = expr.lvalue() && !id->type().isArray();
+    r.field[0] = expr._index;
+    r.field[1] = pool->symbols.size();
 
-Multiply::Multiply(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
+    pool->symbols.push_back(id);
+    return node;
 }
 
 
 /*
- * Function:	Divide::Divide (constructor)
+ * Function:	Node::Unary (constructor)
  *
- * Description:	Initialize a division expression.
+ * Description:	Create a unary operator of the given kind with the
+ *		specified child.  Only a dereference is an lvalue.
  */
 
-Divide::Divide(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
+Node Node::Unary(Kind kind, Node expr, const Type &type)
 {
-}
-
+    Node node = create(kind, type);
+    NodePool::Record &r = pool->records[node._index];
 
-/*
- * Function:	Remainder::Remainder (constructor)
- *
- * Description:	Initialize a remainder expression.
- */
 
-Remainder::Remainder(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
+    r.hasCall = expr.hasCall();
+    r.need = expr.need();
+    r.lvalue = (kind == DEREFERENCE);
+    r.field[0] = expr._index;
+    return node;
 }
 
 
 /*
- * Function:	Add::Add (constructor)
+ * Function:	Node::Binary (constructor)
+ *
+ * Description:	Create a binary operator of the given kind with the
+ *		specified children.
  *
- * Description:	Initialize an addition expression.
+ *		The number of registers needed is that of Sethi and Ullman.
+ *		A number or variable on the right is used where it is, and
+ *		so needs no register of its own.  If both children need the
+ *		same number, one more is needed to hold the first of them
+ *		while the second is computed.
  */
 
-Add::Add(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
+Node Node::Binary(Kind kind, Node left, Node right, const Type &type)
 {
-}
+    Node node = create(kind, type);
+    NodePool::Record &r = pool->records[node._index];
+    unsigned need = right.need();
 
 
-/*
- * Function:	Subtract::Subtract (constructor)
- *
- * Description:	Initialize a subtraction expression.
- */
+    r.hasCall = left.hasCall() | right.hasCall();
 
-Subtract::Subtract(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
-}
+    if (right.kind() == NUMBER || right.kind() == IDENTIFIER)
+	need = 0;
 
+    if (need == left.need())
+	need ++;
+    else if (need < left.need())
+	need = left.need();
 
-/*
- * Function:	LessThan::LessThan (constructor)
- *
- * Description:	Initialize a less-than expression.
- */
-
-LessThan::LessThan(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
+    r.need = need < UCHAR_MAX ? need : UCHAR_MAX;
+    r.field[0] = left._index;
+    r.field[1] = right._index;
+    return node;
 }
 
 
 /*
- * Function:	GreaterThan
+ * Function:	Node::Assignment (constructor)
  *
- * Description:	Initialize a greater-than expression.
+ * Description:	Create an assignment statement.
  */
 
-GreaterThan::GreaterThan(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
+Node Node::Assignment(Node left, Node right)
 {
-}
+    Node node = create(ASSIGNMENT, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	LessOrEqual
- *
- * Description:	Initialize a less-than-or-equal expression.
- */
-
-LessOrEqual::LessOrEqual(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
+    r.hasCall = left.hasCall() | right.hasCall();
+    r.field[0] = left._index;
+    r.field[1] = right._index;
+    return node;
 }
 
 
 /*
- * Function:	GreaterOrEqual
+ * Function:	Node::Return (constructor)
  *
- * Description:	Initialize a greater-than-or-equal expression.
+ * Description:	Create a return statement.
  */
 
-GreaterOrEqual::GreaterOrEqual(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
+Node Node::Return(Node expr)
 {
-}
+    Node node = create(RETURN, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Equal::Equal (constructor)
- *
- * Description:	Initialize an equality expression.
- */
-
-Equal::Equal(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
+    r.hasCall = expr.hasCall();
+    r.field[0] = expr._index;
+    return node;
 }
 
 
 /*
- * Function:	NotEqual::NotEqual (constructor)
+ * Function:	Node::Block (constructor)
  *
- * Description:	Initialize an inequality expression.
+ * Description:	Create a block statement.  Its statements are copied to
+ *		the end of the lists of the pool, and its scope belongs to
+ *		the pool from now on.
  */
 
-NotEqual::NotEqual(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
+Node Node::Block(Scope *decls, const Statements &stmts)
 {
-}
+    Node node = create(BLOCK, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	LogicalAnd::LogicalAnd (constructor)
- *
- * Description:	Initialize a logical-and expression.
- */
+    for (unsigned i = 0; i < stmts.size(); i ++)
+	if (stmts[i].hasCall()) {
+	    r.hasCall = true;
+	    break;
+	}
 
-LogicalAnd::LogicalAnd(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
-{
+    r.field[0] = pool->scopes.size();
+    r.field[1] = pool->lists.size();
+    r.field[2] = stmts.size();
+
+    pool->scopes.push_back(decls);
+    pool->lists.insert(pool->lists.end(), stmts.begin(), stmts.end());
+    return node;
 }
 
 
 /*
- * Function:	LogicalOr::LogicalOr (constructor)
+ * Function:	Node::While (constructor)
  *
- * Description:	Initialize a logical-or expression.
+ * Description:	Create a while statement.
  */
 
-LogicalOr::LogicalOr(Expression *left, Expression *right, const Type &type)
-    : Binary(left, right, type)
+Node Node::While(Node expr, Node stmt)
 {
-}
+    Node node = create(WHILE, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Assignment::Assignment (constructor)
- *
- * Description:	Initialize an assignment statement.
- */
-
-Assignment::Assignment(Expression *left, Expression *right)
-    : _left(left), _right(right)
-{
-    _hasCall = left->_hasCall | right->_hasCall;
+    r.hasCall = expr.hasCall() | stmt.hasCall();
+    r.field[0] = expr._index;
+    r.field[1] = stmt._index;
+    return node;
 }
 
 
 /*
- * Function:	Return::Return (constructor)
+ * Function:	Node::If (constructor)
  *
- * Description:	Initialize a return statement.
+ * Description:	Create an if-then or if-then-else statement.
  */
 
-Return::Return(Expression *expr)
-    : _expr(expr)
+Node Node::If(Node expr, Node thenStmt, Node elseStmt)
 {
-    _hasCall = expr->_hasCall;
-}
+    Node node = create(IF, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Block::Block (constructor)
- *
- * Description:	Initialize a block statement.
- */
+    r.hasCall = expr.hasCall() | thenStmt.hasCall();
 
-Block::Block(Scope *decls, const Statements &stmts)
-    : _decls(decls), _stmts(stmts)
-{
-    for (unsigned i = 0; i < stmts.size(); i ++)
-	if (stmts[i]->_hasCall) {
-	    _hasCall = true;
-	    break;
-	}
+    if (elseStmt && elseStmt.hasCall())
+	r.hasCall = true;
+
+    r.field[0] = expr._index;
+    r.field[1] = thenStmt._index;
+    r.field[2] = elseStmt._index;
+    return node;
 }
 
 
 /*
- * Function:	Block::declarations (accessor)
+ * Function:	Node::Simple (constructor)
  *
- * Description:	Return the declarations of this block.
+ * Description:	Create a simple (expression) statement.
  */
 
-Scope *Block::declarations() const
+Node Node::Simple(Node expr)
 {
-    return _decls;
-}
+    Node node = create(SIMPLE, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	While::While (constructor)
- *
- * Description:	Initialize a while statement.
- */
-
-While::While(Expression *expr, Statement *stmt)
-    : _expr(expr), _stmt(stmt)
-{
-    _hasCall = expr->_hasCall | stmt->_hasCall;
+    r.hasCall = expr.hasCall();
+    r.field[0] = expr._index;
+    return node;
 }
 
 
 /*
- * Function:	If::If (constructor)
+ * Function:	Node::Function (constructor)
  *
- * Description:	Initialize an if-then or if-then-else statement.
+ * Description:	Create a function definition.
  */
 
-If::If(Expression *expr, Statement *thenStmt, Statement *elseStmt)
-    : _expr(expr), _thenStmt(thenStmt), _elseStmt(elseStmt)
+Node Node::Function(Symbol *id, Node body)
 {
-    _hasCall = expr->_hasCall | thenStmt->_hasCall;
-
-    if (elseStmt != nullptr && elseStmt->_hasCall)
-	_hasCall = true;
-}
+    Node node = create(FUNCTION, Type());
+    NodePool::Record &r = pool->records[node._index];
 
 
-/*
- * Function:	Simple::Simple (constructor)
- *
- * Description:	Initialize a simple (expression) statement.
- */
+    r.hasCall = body.hasCall();
+    r.field[0] = pool->symbols.size();
+    r.field[1] = body._index;
 
-Simple::Simple(Expression *expr)
-    : _expr(expr)
-{
-    _hasCall = expr->_hasCall;
+    pool->symbols.push_back(id);
+    return node;
 }
 
 
 /*
- * Function:	Function::Function (constructor)
+ * Function:	Node::isScaled (accessor)
  *
- * Description:	Initialize a function object.
+ * Description:	Return true if this is a multiplication by a constant,
+ *		along with the expression being scaled and the constant.
  */
 
-Function::Function(const Symbol *id, Block *body)
-    : _id(id), _body(body)
+bool Node::isScaled(Node &expr, unsigned long &scale) const
 {
-    _hasCall = body->_hasCall;
+    if (kind() != MULTIPLY || !right().isNumber(scale))
+	return false;
+
+    expr = left();
+    return true;
 }
 
 
 /*
- * Function:	Expression::isNumber (accessor)
+ * Function:	Node::returns (accessor)
  *
- * Description:	Return false since most expressions are not numbers.
+ * Description:	Return true if control never falls out the bottom of this
+ *		statement: it is a return statement, a block whose last
+ *		statement returns, or an if-then-else statement both of
+ *		whose branches return.
  */
 
-bool Expression::isNumber(unsigned long &value) const
+bool Node::returns() const
 {
-    return false;
-}
+    switch (kind()) {
+    case RETURN:
+	return true;
 
+    case BLOCK:
+	return count() > 0 && child(count() - 1).returns();
 
-/*
- * Function:	Number::isNumber (accessor)
- *
- * Description:	Return true since a number is in fact a number.
- */
+    case IF:
+	return elseStmt() && thenStmt().returns() && elseStmt().returns();
 
-bool Number::isNumber(unsigned long &value) const
-{
-    value = strtoul(_value.c_str(), NULL, 0);
-    return true;
+    default:
+	return false;
+    }
 }
@@ -1,27 +1,39 @@
 /*
  * File:	Tree.h
  *
- * Description:	This file contains the class definitions for abstract
- *		syntax trees in Simple C.
+ * Description:	This file contains the definitions for abstract syntax
+ *		trees in Simple C.
  *
- *		The base class Node cannot not be instantiated (the
- *		constructor is private).  It provides empty functions for
- *		storage allocation and code generation.
- *
- *		A Node is either a Function, representing a function
- *		definition, or a Statement, which also cannot be
- *		instantiated (again, the constructor is private).
+ *		A tree is not a hierarchy of classes.  Every node is a
+ *		record in a pool of contiguous arrays, and a Node object is
+ *		just a handle to its record, much as a Type is a handle to
+ *		its record in the table of types.  A record has a kind, a
+ *		few flags, and three 32-bit fields, which are the indices
+ *		of its children or of entries in the side tables for the
+ *		things that a node refers to but does not own: symbols,
+ *		scopes, string literals, and the lists of arguments and
+ *		statements.  The type of each expression, and the register
+ *		or spill slot holding its value during code generation, are
+ *		kept in arrays parallel to the records, so a pass that does
+ *		not need them does not bring them into the cache.
  *
  *		Since the compiler has a very functional design (semantic
- *		checking, storage allocation, code generation), its design
- *		doesn't necessarily mesh well with a tree designed using
- *		object-orientation.  So, here is my compromise:
+ *		checking, storage allocation, code generation), each pass
+ *		is a function of Node that dispatches on the kind with a
+ *		switch:
  *
- *		Tree.h - class definitions
+ *		Tree.h - the node pool and its handles
  *		Tree.cpp - constructors and accessors
- *		allocator.cpp - member functions to do storage allocation
- *		generator.cpp - member functions to do code generation
- *		writer.cpp - member functions to write the tree of a stream
+ *		allocator.cpp - storage allocation
+ *		generator.cpp - code generation
+ *		writer.cpp - writing the tree to a stream
+ *
+ *		Each function is generated as soon as it is parsed, and its
+ *		tree is never used again.  So, the pool is emptied all at
+ *		once after each function, and the memory used for trees
+ *		depends only on the size of the largest function and not on
+ *		the size of the program.  Emptying the pool also deletes the
+ *		scope of every block and the symbols declared in it.
  */
 
 # ifndef TREE_H
@@ -31,611 +43,307 @@
 # include <vector>
 # include <ostream>
 
-# include "Label.h"
 # include "Scope.h"
-# include "Register.h"
-
 
-typedef std::vector<class Statement *> Statements;
-typedef std::vector<class Expression *> Expressions;
 
+typedef std::vector<class Node> Statements;
+typedef std::vector<class Node> Expressions;
 
-/* The base class */
-
-class Node 
-{
-
-    protected:
+class Register;
 
-        typedef std::string string;
-        typedef std::ostream ostream;
-
-        Node() : _hasCall(false) {}
-
-    public:
 
-        /* True if this node contains a function call */
-        bool _hasCall;
-
-        virtual ~Node() {}
-
-        /* Prints the contents of the node to standard error for debug purposes */
-        virtual void write(ostream& ostr) const {}
-
-        /* Inserts this node into memory by updating the provided offset and the offsets of relevant symbols */
-        virtual void allocate(int& offset) const {}
-
-        /* Generates 64-bit Linux Assembly code for this node to the standard output */
-        virtual void generate() {}
-
-        /* Generates 64-bit Linux Assembly code for this node to the standard output */
-        virtual void generate_indirect(bool& indirect) {}
+/* A handle to a node; the default handle refers to no node at all */
 
-};
-
-
-/* Any type of statement: return, while, if, block, and expression */
-
-class Statement : public Node 
-{
-
-    protected:
-        Statement() {}
-
-};
-
-
-/* An expression */
-
-class Expression : public Node 
+class Node
 {
 
-    protected:
-
-        Type _type;
-        bool _lvalue;
-
-        Expression(const Type& type);
-
     public:
 
-        int         _offset;
-        Register*   _register;
-
-        const Type& type() const;
-        const bool lvalue() const;
-
-        virtual bool isNumber(unsigned long& value) const;
-
-        virtual void generate_indirect(bool& indirect);
-        virtual void operand(ostream& ostr) const;
-        virtual void test(const Label& label, bool ifTrue);
-
-};
-
+        enum Kind : unsigned char {
+            STRING, IDENTIFIER, NUMBER, CALL, FIELD,
+            NOT, NEGATE, DEREFERENCE, ADDRESS, CAST,
+            MULTIPLY, DIVIDE, REMAINDER, ADD, SUBTRACT,
+            LESS_THAN, GREATER_THAN, LESS_OR_EQUAL, GREATER_OR_EQUAL,
+            EQUAL, NOT_EQUAL, LOGICAL_AND, LOGICAL_OR,
+            ASSIGNMENT, RETURN, BLOCK, WHILE, IF, SIMPLE, FUNCTION
+        };
 
-/* A binary operator */
+    private:
 
-class Binary : public Expression 
-{
-
-    protected:
-
-        Expression* _left;
-        Expression* _right;
-
-        Binary(Expression* left, Expression* right, const Type& type);
-
-};
-
-
-/* A unary operator */
-
-class Unary : public Expression 
-{
-
-    protected:
-
-        Expression* _expr;
-
-        Unary(Expression* expr, const Type& type);
-
-};
+        typedef std::string string;
+        typedef std::ostream ostream;
 
+        unsigned _index;
 
-/* A string literal (strings really are just not expressions syntactically) */
+        explicit Node(unsigned index) : _index(index) {}
 
-class String : public Expression 
-{
+        static Node create(Kind kind, const Type& type);
 
-    string _value;
+        friend struct NodePool;
 
     public:
 
-        String(const string& value);
+        Node() : _index(0) {}
 
-        const string& value() const;
+        /* The constructors, one for each kind or group of kinds */
+        static Node String(const string& value);
+        static Node Identifier(Symbol* symbol);
+        static Node Number(const string& value);
+        static Node Number(unsigned long value);
+        static Node Call(Symbol* id, const Expressions& args, const Type& type);
+        static Node Field(Node expr, Symbol* id, const Type& type);
+        static Node Unary(Kind kind, Node expr, const Type& type);
+        static Node Binary(Kind kind, Node left, Node right, const Type& type);
+        static Node Assignment(Node left, Node right);
+        static Node Return(Node expr);
+        static Node Block(Scope* decls, const Statements& stmts);
+        static Node While(Node expr, Node stmt);
+        static Node If(Node expr, Node thenStmt, Node elseStmt);
+        static Node Simple(Node expr);
+        static Node Function(Symbol* id, Node body);
 
-        virtual void write(ostream& ostr) const;
-        virtual void operand(ostream& ostr) const;
+        /* Destroys every node in the pool so its memory can be reused */
+        static void release();
 
-};
+        bool operator ==(const Node& rhs) const { return _index == rhs._index; }
+        bool operator !=(const Node& rhs) const { return _index != rhs._index; }
+        explicit operator bool() const { return _index != 0; }
 
+        unsigned index() const { return _index; }
 
-/* An identifier expression */
-
-class Identifier : public Expression
-{
+        Kind kind() const;
+        Type type() const;
+        bool lvalue() const;
 
-    const Symbol* _symbol;
-
-    public:
-
-        Identifier(const Symbol *symbol);
-
-        const Symbol *symbol() const;
-
-        virtual void write(ostream& ostr) const;
-        virtual void operand(ostream& ostr) const;
-
-};
-
-
-/* A number (i.e., integer literal) */
+        /* True if this node contains a function call */
+        bool hasCall() const;
+
+        /* The number of registers needed to compute this expression */
+        unsigned need() const;
+
+        /* Where the value of this expression is during code generation */
+        Register*& reg() const;
+        int& offset() const;
+
+        Node expr() const;
+        Node left() const;
+        Node right() const;
+        Node stmt() const;
+        Node thenStmt() const;
+        Node elseStmt() const;
+        Node body() const;
+
+        Symbol* symbol() const;
+        unsigned long value() const;
+        const string& text() const;
+        Scope* declarations() const;
 
-class Number : public Expression 
-{
+        /* The arguments of a call or the statements of a block */
+        unsigned count() const;
+        Node child(unsigned i) const;
 
-    string _value;
+        bool isNumber(unsigned long& value) const;
+        bool isIdentifier(Symbol*& symbol) const;
+        bool isAddress(Node& expr) const;
+        bool isScaled(Node& expr, unsigned long& scale) const;
 
-    public:
+        /* True if control never falls out the bottom of this statement */
+        bool returns() const;
 
-        Number(const string& value);
-        Number(unsigned long value);
+        /* Prints the contents of the node to standard error for debug purposes */
+        void write(ostream& ostr) const;
 
-        const string& value() const;
+        /* Inserts this node into memory by updating the provided offset and the offsets of relevant symbols */
+        void allocate(int& offset) const;
 
-        virtual bool isNumber(unsigned long& value) const;
-        virtual void write(ostream& ostr) const;
-        virtual void operand(ostream& ostr) const;
+        /* Generates 64-bit Linux Assembly code for this node to the standard output */
+        void generate() const;
 
 };
 
 
-/* A function call expression: id ( args ) */
+/* The pool of nodes for the current function.  The meaning of the three
+   fields of a record depends on its kind:
 
-class Call : public Expression 
-{
+	STRING		index of the literal in strings
+	IDENTIFIER	index of the symbol in symbols
+	NUMBER		low and high halves of the value
+	CALL		index of the symbol, first and count in lists
+	FIELD		expression, index of the symbol
+	unary		expression
+	binary		left, right
+	ASSIGNMENT	left, right
+	RETURN, SIMPLE	expression
+	BLOCK		index of the scope in scopes, first and count in lists
+	WHILE		expression, statement
+	IF		expression, then statement, else statement or zero
+	FUNCTION	index of the symbol, body
 
-    const Symbol*   _id;
-    Expressions     _args;
+   The first record is never used, so that zero refers to no node. */
 
-    public:
-
-        Call(const Symbol* id, const Expressions& args, const Type& type);
-
-        virtual void write(ostream& ostr) const;
-        virtual void generate();
-
-};
-
-
-/* A field reference: expr . id */
-
-class Field : public Expression 
+struct NodePool
 {
+    struct Record
+    {
+        Node::Kind      kind;
+        unsigned char   need;
+        bool            lvalue;
+        bool            hasCall;
+        unsigned        field[3];
+    };
 
-    Expression* _expr;
-    Symbol*     _id;
-
-    public:
+    std::vector<Record>         records;
+    std::vector<Type>           types;
+    std::vector<Register*>      registers;
+    std::vector<int>            offsets;
 
-        Field(Expression* expr, Symbol* id, const Type& type);
-
-        virtual void write(ostream& ostr) const;
-        virtual void generate();
+    std::vector<Symbol*>        symbols;
+    std::vector<Scope*>         scopes;
+    std::vector<std::string>    strings;
+    std::vector<Node>           lists;
 
+    NodePool();
+    ~NodePool();
+    void clear();
 };
 
+/* The pool of this thread.  It is a plain pointer, set when the pool is
+   constructed, so that reading it from another file does not first call
+   a function to make sure that the pool has been constructed. */
 
-/* A logical negation expression: ! expr */
+extern thread_local NodePool *pool;
 
-class Not : public Unary 
-{
 
-    public:
-
-        Not(Expression* expr, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* An arithmetic negation expression: - expr */
+/* The accessors are used on every node by every pass, and so are defined
+   here where they can be inlined, and reach the pool through the pointer. */
 
-class Negate : public Unary 
+inline Node::Kind Node::kind() const
 {
+    return pool->records[_index].kind;
+}
 
-    public:
-
-        Negate(Expression* expr, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A dereference expression: * expr */
-
-class Dereference : public Unary 
+inline Type Node::type() const
 {
+    return pool->types[_index];
+}
 
-    public:
-
-        Dereference(Expression* expr, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-        void generate_indirect(bool& indirect);
-
-};
-
-
-/* An address expression:&  expr */
-
-class Address : public Unary 
+inline bool Node::lvalue() const
 {
+    return pool->records[_index].lvalue;
+}
 
-    public:
-
-        Address(Expression* expr, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A cast expression: (type) expr */
-
-class Cast : public Unary 
+inline bool Node::hasCall() const
 {
+    return pool->records[_index].hasCall;
+}
 
-    public:
-
-        Cast(Expression* expr, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A multiply expression: left * right */
-
-class Multiply : public Binary 
+inline unsigned Node::need() const
 {
+    return pool->records[_index].need;
+}
 
-    public:
-
-        Multiply(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A divide expression: left / right */
-
-class Divide : public Binary 
+inline Register*& Node::reg() const
 {
+    return pool->registers[_index];
+}
 
-    public:
-
-        Divide(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A remainder expression: left % right */
-
-class Remainder : public Binary 
+inline int& Node::offset() const
 {
+    return pool->offsets[_index];
+}
 
-    public:
-
-        Remainder(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* An addition expression: left + right */
-
-class Add : public Binary 
+inline Node Node::expr() const
 {
+    return Node(pool->records[_index].field[0]);
+}
 
-    public:
-
-        Add(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A subtraction expression: left - right */
-
-class Subtract : public Binary 
+inline Node Node::left() const
 {
+    return Node(pool->records[_index].field[0]);
+}
 
-    public:
-
-        Subtract(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A less-than expression: left < right */
-
-class LessThan : public Binary 
+inline Node Node::right() const
 {
+    return Node(pool->records[_index].field[1]);
+}
 
-    public:
-
-        LessThan(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* A greater-than expression: left > right */
-
-class GreaterThan : public Binary 
+inline Node Node::stmt() const
 {
+    return Node(pool->records[_index].field[1]);
+}
 
-    public:
-
-        GreaterThan(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* A less-than-or-equal expression: left <= right */
-
-class LessOrEqual : public Binary 
+inline Node Node::thenStmt() const
 {
+    return Node(pool->records[_index].field[1]);
+}
 
-    public:
-
-        LessOrEqual(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* A greater-than-or-equal expression: left >= right */
-
-class GreaterOrEqual : public Binary 
-{
-
-    public:
-
-        GreaterOrEqual(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* An equality expression: left == right */
-
-class Equal : public Binary 
+inline Node Node::elseStmt() const
 {
+    return Node(pool->records[_index].field[2]);
+}
 
-    public:
-
-        Equal(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* An inequality expression: left != right */
-
-class NotEqual : public Binary 
+inline Node Node::body() const
 {
+    return Node(pool->records[_index].field[1]);
+}
 
-    public:
-
-        NotEqual(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* A logical-and expression: left& & right */
-
-class LogicalAnd: public Binary 
+inline Symbol* Node::symbol() const
 {
+    const NodePool::Record& r = pool->records[_index];
+    return pool->symbols[r.kind == FIELD ? r.field[1] : r.field[0]];
+}
 
-    public:
-
-        LogicalAnd(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* A logical-or expression: left || right */
-
-class LogicalOr : public Binary 
+inline unsigned long Node::value() const
 {
+    const NodePool::Record& r = pool->records[_index];
+    return r.field[0] | (unsigned long) r.field[1] << 32;
+}
 
-    public:
-
-        LogicalOr(Expression* left, Expression* right, const Type& type);
-
-        void write(ostream& ostr) const;
-        void test(const Label& label, bool onTrue);
-
-};
-
-
-/* An assignment statement: left = right */
-
-class Assignment : public Statement 
+inline const std::string& Node::text() const
 {
+    return pool->strings[pool->records[_index].field[0]];
+}
 
-    Expression* _left;
-    Expression* _right;
-
-    public:
-
-        Assignment(Expression* left, Expression* right);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A return statement: return expr */
-
-class Return : public Statement 
+inline Scope* Node::declarations() const
 {
+    return pool->scopes[pool->records[_index].field[0]];
+}
 
-    Expression* _expr;
-
-    public:
-
-        Return(Expression* expr);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A block (compound) statement: { decls stmts } */
-
-class Block : public Statement 
+inline unsigned Node::count() const
 {
+    return pool->records[_index].field[2];
+}
 
-    Scope*      _decls;
-    Statements  _stmts;
-
-    public:
-
-        Block(Scope* decls, const Statements& stmts);
-
-        Scope* declarations() const;
-
-        void write(ostream& ostr) const;
-        void allocate(int& offset) const;
-        void generate();
-};
-
-
-/* A while statement: while ( expr ) stmt */
-
-class While : public Statement 
+inline Node Node::child(unsigned i) const
 {
-    
-    Expression* _expr;
-    Statement*  _stmt;
-
-    public:
-
-        While(Expression* expr, Statement* stmt);
-
-        void write(ostream& ostr) const;
-        void allocate(int& offset) const;
-        void generate();
-
-};
-
-
-/* An if-then or if-then-else statement: if ( expr ) thenStmt else elseStmt */
+    return pool->lists[pool->records[_index].field[1] + i];
+}
 
-class If : public Statement 
+inline bool Node::isNumber(unsigned long& value) const
 {
+    if (kind() != NUMBER)
+        return false;
 
-    Expression* _expr;
-    Statement*  _thenStmt;
-    Statement*  _elseStmt;
-
-    public:
-
-        If(Expression* expr, Statement* thenStmt, Statement* elseStmt);
-
-        void write(ostream& ostr) const;
-        void allocate(int& offset) const;
-        void generate();
-
-};
-
-
-/* A simple (expression) statement */
+    value = this->value();
+    return true;
+}
 
-class Simple : public Statement 
+inline bool Node::isIdentifier(Symbol*& symbol) const
 {
+    if (kind() != IDENTIFIER)
+        return false;
 
-    Expression* _expr;
-
-    public:
-
-        Simple(Expression *expr);
-
-        void write(ostream& ostr) const;
-        void generate();
-
-};
-
-
-/* A function definition: id() { body } */
+    symbol = this->symbol();
+    return true;
+}
 
-class Function : public Node 
+inline bool Node::isAddress(Node& expr) const
 {
+    if (kind() != ADDRESS)
+        return false;
 
-    const Symbol*   _id;
-    Block*          _body;
-
-    public:
-
-        Function(const Symbol *id, Block *body);
-
-        void write(ostream& ostr) const;
-        void allocate(int& offset) const;
-        void generate();
-
-};
+    expr = this->expr();
+    return true;
+}
 
 # endif /* TREE_H */
@@ -12,6 +12,14 @@
  *		But, C++ lets us have value types with access control
  *		instead of just always using pointer types.
  *
+ *		Each thread has a table of types of its own, just as it
+ *		has its own table of atoms, so creating a type never needs
+ *		a lock.  A few types are predefined and shared by every
+ *		table, so that they may be created during static
+ *		initialization and used on any thread.  Nothing about them
+ *		is ever computed lazily, since promoting one of them yields
+ *		itself and none of them may be dereferenced.
+ *
  *		Extra functionality:
  *		- equality and inequality operators
  *		- predicate functions such as isArray()
@@ -20,10 +28,181 @@
  */
 
 # include <cassert>
+# include <deque>
+# include <functional>
 # include "Type.h"
 
 using namespace std;
 
+Type::Record Type::_predefined[] = {
+    {ERROR, errorAtom, 0, 0, nullptr, nullptr, nullptr},
+    {SIMPLE, intAtom, 0, 0, nullptr, nullptr, nullptr},
+    {SIMPLE, longAtom, 0, 0, nullptr, nullptr, nullptr},
+};
+
+struct TypeTable {
+    typedef Type::Record Record;
+
+    deque<Record> records;
+    vector<const Record *> slots;
+
+    static unsigned hash(unsigned kind, const Atom &specifier,
+	unsigned indirection, unsigned long length,
+	const Parameters *parameters);
+
+    TypeTable();
+    ~TypeTable();
+    void place(const Record *r);
+    const Record *intern(Type::Kind kind, const Atom &specifier,
+	unsigned indirection, unsigned long length,
+	const Parameters *parameters);
+};
+
+
+/*
+ * Function:	TypeTable::hash
+ *
+ * Description:	Return a hash of the given fields of a type.  A parameter
+ *		type is already in the table, so it is hashed by its
+ *		address.
+ */
+
+unsigned TypeTable::hash(unsigned kind, const Atom &specifier,
+	unsigned indirection, unsigned long length,
+	const Parameters *parameters)
+{
+    size_t h = kind;
+
+
+    h = h * 31 + specifier.index();
+    h = h * 31 + indirection;
+    h = h * 31 + length;
+
+    if (parameters != nullptr) {
+	h = h * 31 + parameters->size() + 1;
+
+	for (unsigned i = 0; i < parameters->size(); i ++)
+	    h = h * 31 + std::hash<const void *>()((*parameters)[i]._record);
+    }
+
+    return (h ^ h >> 16) * 2654435769u;
+}
+
+
+/*
+ * Function:	TypeTable::TypeTable (constructor)
+ *
+ * Description:	Initialize the table with the predefined types.
+ */
+
+TypeTable::TypeTable()
+    : slots(256, nullptr)
+{
+    for (const Record &r : Type::_predefined)
+	place(&r);
+}
+
+
+/*
+ * Function:	TypeTable::~TypeTable (destructor)
+ *
+ * Description:	Release the parameter lists owned by the table.
+ */
+
+TypeTable::~TypeTable()
+{
+    for (unsigned i = 0; i < records.size(); i ++)
+	delete records[i].parameters;
+}
+
+
+/*
+ * Function:	TypeTable::place
+ *
+ * Description:	Place a record known not to be in the table into the first
+ *		free slot at or after its hash.
+ */
+
+void TypeTable::place(const Record *r)
+{
+    unsigned mask = slots.size() - 1;
+    unsigned i = hash(r->kind, r->specifier, r->indirection, r->length,
+	    r->parameters);
+
+
+    for (i &= mask; slots[i] != nullptr; i = (i + 1) & mask)
+	;
+
+    slots[i] = r;
+}
+
+
+/*
+ * Function:	TypeTable::intern
+ *
+ * Description:	Return the record of the given type, adding it to the
+ *		table if it isn't already there.  The table is doubled
+ *		whenever it becomes half full.
+ */
+
+const Type::Record *TypeTable::intern(Type::Kind kind, const Atom &specifier,
+	unsigned indirection, unsigned long length,
+	const Parameters *parameters)
+{
+    unsigned mask = slots.size() - 1;
+    unsigned i = hash(kind, specifier, indirection, length, parameters);
+    const Record *r;
+
+
+    for (i &= mask; (r = slots[i]) != nullptr; i = (i + 1) & mask)
+	if (r->kind == kind && r->specifier == specifier &&
+		r->indirection == indirection && r->length == length &&
+		(r->parameters == nullptr) == (parameters == nullptr) &&
+		(parameters == nullptr || *r->parameters == *parameters))
+	    return r;
+
+    records.push_back(Record {kind, specifier, indirection, length,
+	parameters ? new Parameters(*parameters) : nullptr, nullptr, nullptr});
+    r = slots[i] = &records.back();
+
+    if (records.size() * 2 > slots.size()) {
+	vector<const Record *> old(slots.size() * 2, nullptr);
+
+	old.swap(slots);
+
+	for (unsigned j = 0; j < old.size(); j ++)
+	    if (old[j] != nullptr)
+		place(old[j]);
+    }
+
+    return r;
+}
+
+
+/*
+ * Function:	table (private)
+ *
+ * Description:	Return the table of types for this thread.
+ */
+
+static TypeTable &table()
+{
+    static thread_local TypeTable types;
+    return types;
+}
+
+
+/*
+ * Function:	Type::Type (constructor)
+ *
+ * Description:	Initialize this type as a handle to the given record.
+ */
+
+Type::Type(const Record *record)
+    : _record(record)
+{
+}
+
 
 /*
  * Function:	Type::Type (constructor)
@@ -32,7 +211,7 @@ using namespace std;
  */
 
 Type::Type()
-    : _specifier("error"), _kind(ERROR)
+    : _record(&_predefined[0])
 {
 }
 
@@ -40,12 +219,19 @@ Type::Type()
 /*
  * Function:	Type::Type (constructor)
  *
- * Description:	Initialize this type object as a simple type.
+ * Description:	Initialize this type object as a simple type.  The
+ *		numeric types are by far the most common, and are already
+ *		at hand without looking in the table.
  */
 
-Type::Type(const string &specifier, unsigned indirection)
-    : _specifier(specifier), _indirection(indirection), _kind(SIMPLE)
+Type::Type(const Atom &specifier, unsigned indirection)
 {
+    if (indirection == 0 && specifier == intAtom)
+	_record = &_predefined[1];
+    else if (indirection == 0 && specifier == longAtom)
+	_record = &_predefined[2];
+    else
+	_record = table().intern(SIMPLE, specifier, indirection, 0, nullptr);
 }
 
 
@@ -55,10 +241,9 @@ Type::Type(const string &specifier, unsigned indirection)
  * Description:	Initialize this type object as an array type.
  */
 
-Type::Type(const string &specifier, unsigned indirection, unsigned long length)
-    : _specifier(specifier), _indirection(indirection), _length(length)
+Type::Type(const Atom &specifier, unsigned indirection, unsigned long length)
+    : _record(table().intern(ARRAY, specifier, indirection, length, nullptr))
 {
-    _kind = ARRAY;
 }
 
 
@@ -68,45 +253,39 @@ Type::Type(const string &specifier, unsigned indirection, unsigned long length)
  * Description:	Initialize this type object as a function type.
  */
 
-Type::Type(const string &specifier, unsigned indirection, Parameters *parameters)
-    : _specifier(specifier), _indirection(indirection), _parameters(parameters)
+Type::Type(const Atom &specifier, unsigned indirection,
+	const Parameters *parameters)
+    : _record(table().intern(FUNCTION, specifier, indirection, 0, parameters))
 {
-    _kind = FUNCTION;
 }
 
 
 /*
  * Function:	Type::operator ==
  *
- * Description:	Return whether another type is equal to this type.  The
- *		parameter lists are checked for function types, which C++
- *		makes so easy.  (At least, it makes something easy!)
+ * Description:	Return whether another type is equal to this type.  Since
+ *		each type is in the table exactly once, only function types
+ *		with an unspecified parameter list need a closer look.
  */
 
 bool Type::operator ==(const Type &rhs) const
 {
-    if (_kind != rhs._kind)
-	return false;
+    const Record *r = rhs._record;
+
 
-    if (_kind == ERROR)
+    if (_record == r)
 	return true;
 
-    if (_specifier != rhs._specifier)
+    if (_record->kind != FUNCTION || r->kind != FUNCTION)
 	return false;
 
-    if (_indirection != rhs._indirection)
+    if (_record->specifier != r->specifier)
 	return false;
 
-    if (_kind == SIMPLE)
-	return true;
-
-    if (_kind == ARRAY)
-	return _length == rhs._length;
-
-    if (!_parameters || !rhs._parameters)
-	return true;
+    if (_record->indirection != r->indirection)
+	return false;
 
-    return *_parameters == *rhs._parameters;
+    return !_record->parameters || !r->parameters;
 }
 
 
@@ -132,7 +311,7 @@ bool Type::operator !=(const Type &rhs) const
 
 bool Type::isArray() const
 {
-    return _kind == ARRAY;
+    return _record->kind == ARRAY;
 }
 
 
@@ -144,7 +323,7 @@ bool Type::isArray() const
 
 bool Type::isError() const
 {
-    return _kind == ERROR;
+    return _record->kind == ERROR;
 }
 
 
@@ -156,7 +335,7 @@ bool Type::isError() const
 
 bool Type::isFunction() const
 {
-    return _kind == FUNCTION;
+    return _record->kind == FUNCTION;
 }
 
 
@@ -168,7 +347,7 @@ bool Type::isFunction() const
 
 bool Type::isSimple() const
 {
-    return _kind == SIMPLE;
+    return _record->kind == SIMPLE;
 }
 
 
@@ -178,9 +357,9 @@ bool Type::isSimple() const
  * Description:	Return the specifier of this type.
  */
 
-const string &Type::specifier() const
+const Atom &Type::specifier() const
 {
-    return _specifier;
+    return _record->specifier;
 }
 
 
@@ -192,7 +371,7 @@ const string &Type::specifier() const
 
 unsigned Type::indirection() const
 {
-    return _indirection;
+    return _record->indirection;
 }
 
 
@@ -206,8 +385,8 @@ unsigned Type::indirection() const
 
 unsigned long Type::length() const
 {
-    assert(_kind == ARRAY);
-    return _length;
+    assert(_record->kind == ARRAY);
+    return _record->length;
 }
 
 
@@ -218,10 +397,10 @@ unsigned long Type::length() const
  *		function type.
  */
 
-Parameters *Type::parameters() const
+const Parameters *Type::parameters() const
 {
-    assert(_kind == FUNCTION);
-    return _parameters;
+    assert(_record->kind == FUNCTION);
+    return _record->parameters;
 }
 
 
@@ -233,7 +412,9 @@ Parameters *Type::parameters() const
 
 bool Type::isStruct() const
 {
-    return _kind != ERROR && _specifier != "int" && _specifier != "long";
+    const Record *r = _record;
+
+    return r->kind != ERROR && r->specifier != intAtom && r->specifier != longAtom;
 }
 
 
@@ -283,10 +464,12 @@ bool Type::isScalar() const
 
 bool Type::isNumeric() const
 {
-    if (_kind != SIMPLE || _indirection > 0)
+    const Record *r = _record;
+
+    if (r->kind != SIMPLE || r->indirection > 0)
 	return false;
 
-    return _specifier == "int" || _specifier == "long";
+    return r->specifier == intAtom || r->specifier == longAtom;
 }
 
 
@@ -298,7 +481,9 @@ bool Type::isNumeric() const
 
 bool Type::isPointer() const
 {
-    return (_kind == SIMPLE && _indirection > 0) || _kind == ARRAY;
+    const Record *r = _record;
+
+    return (r->kind == SIMPLE && r->indirection > 0) || r->kind == ARRAY;
 }
 
 
@@ -315,7 +500,7 @@ bool Type::isCompatibleWith(const Type &that) const
     if (isNumeric() && that.isNumeric())
 	return true;
 
-    return isScalar() && promote() == that.promote();
+    return isScalar() && promote()._record == that.promote()._record;
 }
 
 
@@ -328,7 +513,16 @@ bool Type::isCompatibleWith(const Type &that) const
 
 Type Type::promote() const
 {
-    return _kind == ARRAY ? Type(_specifier, _indirection + 1) : *this;
+    const Record *r = _record;
+
+
+    if (r->kind != ARRAY)
+	return *this;
+
+    if (r->promoted == nullptr)
+	r->promoted = Type(r->specifier, r->indirection + 1)._record;
+
+    return r->promoted;
 }
 
 
@@ -341,6 +535,14 @@ Type Type::promote() const
 
 Type Type::deref() const
 {
+    const Record *r = _record;
+
+
     assert(isPointer());
-    return Type(_specifier, _kind == ARRAY ? _indirection : _indirection - 1);
+
+    if (r->dereferenced == nullptr)
+	r->dereferenced = Type(r->specifier, r->kind == ARRAY ?
+		r->indirection : r->indirection - 1)._record;
+
+    return r->dereferenced;
 }
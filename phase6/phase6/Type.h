@@ -17,34 +17,57 @@
  *		slicing (since we'll be treating types as value types) and
  *		the proliferation of small member functions.
  *
- *		As we've designed them, types are essentially immutable,
- *		since we haven't included any mutators.  In practice, we'll
- *		be creating new types rather than changing existing types.
+ *		The specifier is an atom rather than a string, so comparing
+ *		specifiers, as when comparing types or computing sizes, is
+ *		just an integer comparison.
+ *
+ *		Types are immutable, and every distinct type is created
+ *		exactly once in a table of types.  A type object is then
+ *		just a handle to its record in that table, which makes it
+ *		cheap to copy and store in every symbol and expression, and
+ *		two types are equal exactly when their handles are, except
+ *		for the function types with unspecified parameters, which
+ *		are equal to any function type with the same result.  The
+ *		results of promoting and dereferencing a type are computed
+ *		once and remembered in its record.  A parameter list given
+ *		to the constructor is copied into the table, so it still
+ *		belongs to the caller.
  */
 
 # ifndef TYPE_H
 # define TYPE_H
 # include <vector>
-# include <string>
 # include <ostream>
+# include "Atom.h"
 
 typedef std::vector<class Type> Parameters;
 
 class Type {
-    typedef std::string string;
+    enum Kind { ARRAY, ERROR, FUNCTION, SIMPLE };
+
+    struct Record {
+	Kind kind;
+	Atom specifier;
+	unsigned indirection;
+	unsigned long length;
+	Parameters *parameters;
+	mutable const Record *promoted, *dereferenced;
+    };
+
+    friend struct TypeTable;
+
+    const Record *_record;
 
-    string _specifier;
-    unsigned _indirection;
-    unsigned long _length;
-    Parameters *_parameters;
+    Type(const Record *record);
 
-    enum { ARRAY, ERROR, FUNCTION, SIMPLE } _kind;
+    static Record _predefined[];
 
 public:
     Type();
-    Type(const string &specifier, unsigned indirection = 0);
-    Type(const string &specifier, unsigned indirection, unsigned long length);
-    Type(const string &specifier, unsigned indirection, Parameters *parameters);
+    Type(const Atom &specifier, unsigned indirection = 0);
+    Type(const Atom &specifier, unsigned indirection, unsigned long length);
+    Type(const Atom &specifier, unsigned indirection,
+	    const Parameters *parameters);
 
     bool operator ==(const Type &rhs) const;
     bool operator !=(const Type &rhs) const;
@@ -54,10 +77,10 @@ public:
     bool isFunction() const;
     bool isSimple() const;
 
-    const string &specifier() const;
+    const Atom &specifier() const;
     unsigned indirection() const;
     unsigned long length() const;
-    Parameters *parameters() const;
+    const Parameters *parameters() const;
 
     bool isStruct() const;
     bool isScalar() const;
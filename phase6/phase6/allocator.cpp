@@ -1,77 +1,52 @@
 /*
  * File:	allocator.cpp
  *
- * Description:	This file contains the member function definitions for
- *		functions dealing with storage allocation.  The actual
- *		classes are declared elsewhere, mainly in Tree.h.
+ * Description:	This file contains the function definitions for functions
+ *		dealing with storage allocation.  The actual classes are
+ *		declared elsewhere, mainly in Tree.h.
  *
  *		Extra functionality:
  *		- maintaining minimum offset in nested blocks
  *		- allocation within while and if-then-else statements
  */
 
-# include <map>
+# include <algorithm>
 # include <cassert>
 # include <iostream>
 
 # include "checker.h"
+# include "generator.h"
+# include "lexer.h"
 # include "machine.h"
 # include "tokens.h"
 # include "Tree.h"
 
 using namespace std;
 
-static map<string, unsigned long> sizes;
-
 /*
  * Function:	Type::size
  *
- * Description:	Return the size of a type in bytes.
+ * Description:	Return the size of a type in bytes.  The size of a
+ *		structure was computed along with its layout when its
+ *		fields were all declared.
  */
 
 unsigned long Type::size() const
 {
-    assert(_kind != FUNCTION && _kind != ERROR);
+    assert(_record->kind != FUNCTION && _record->kind != ERROR);
 
-    unsigned long count = (_kind == ARRAY ? _length : 1);
+    unsigned long count = (_record->kind == ARRAY ? _record->length : 1);
 
-    if (_indirection > 0 || _specifier == "char")
+    if (_record->indirection > 0 || _record->specifier == charAtom)
 	    return count * SIZEOF_PTR;
 
-    if (_specifier == "long")
+    if (_record->specifier == longAtom)
 	    return count * SIZEOF_LONG;
 
-    if (_specifier == "int")
+    if (_record->specifier == intAtom)
 	    return count * SIZEOF_INT;
 
-    if (sizes.count(_specifier) > 0)
-	    return count * sizes[_specifier];
-
-    /* The size of a structure is the size of all of its fields, but with
-       each field aligned and the entire structure aligned as well.  Since
-       this is rather expensive to compute, we cache the result. */
-
-    unsigned align, size = 0;
-    const Symbols& symbols = getFields(_specifier)->symbols();
-
-    for (unsigned i = 0; i < symbols.size(); i ++) 
-    {
-        align = symbols[i]->type().alignment();
-
-        if (size % align != 0)
-            size += (align - size % align);
-
-        symbols[i]->_offset = size;
-        size += symbols[i]->type().size();
-    }
-
-    align = alignment();
-
-    if (size % align != 0)
-	    size += (align - size % align);
-
-    sizes[_specifier] = size;
-    return size;
+    return count * getLayout(_record->specifier)->size;
 }
 
 
@@ -83,53 +58,58 @@ unsigned long Type::size() const
 
 unsigned Type::alignment() const
 {
-    assert(_kind != FUNCTION && _kind != ERROR);
+    assert(_record->kind != FUNCTION && _record->kind != ERROR);
 
-    if (_indirection > 0)
+    if (_record->indirection > 0)
 	    return ALIGNOF_PTR;
 
-    if (_specifier == "long")
+    if (_record->specifier == longAtom)
 	    return ALIGNOF_LONG;
 
-    if (_specifier == "int")
+    if (_record->specifier == intAtom)
 	    return ALIGNOF_INT;
 
-    /* The alignment of a structure is the maximum alignment of its fields. */
-
-    unsigned align = 0;
-    const Symbols& symbols = getFields(_specifier)->symbols();
-
-    for (unsigned i = 0; i < symbols.size(); ++ i)
-	    if (symbols[i]->type().alignment() > align)
-	        align = symbols[i]->type().alignment();
-
-    return align;
+    return getLayout(_record->specifier)->alignment;
 }
 
 
 /*
- * Function:	Block::allocate
+ * Function:	allocate_block (private)
  *
- * Description:	Allocate storage for this block.  We assign decreasing
+ * Description:	Allocate storage for a block.  We assign decreasing
  *		offsets for all symbols declared within this block, and
  *		then for all symbols declared within any nested block.
  *		Only symbols that have not already been allocated an offset
  *		will be assigned one, since some parameters are already
  *		assigned special offsets.
+ *
+ *		Before any offsets are assigned, the symbols used most
+ *		often are offered to the code generator to be kept in
+ *		registers, and those that it takes need no storage at all.
  */
 
-void Block::allocate(int& offset) const
+static void allocate_block(Node block, int& offset)
 {
     int temp, saved;
     unsigned i;
-    Symbols symbols;
+    Symbols symbols, busiest;
+
+    symbols = block.declarations()->symbols();
+    busiest = symbols;
+
+    stable_sort(busiest.begin(), busiest.end(), [](Symbol *a, Symbol *b) {
+        return a->_uses > b->_uses;
+    });
 
-    symbols = _decls->symbols();
+    for (i = 0; i < busiest.size(); ++ i)
+        if (busiest[i]->_register == nullptr)
+            promote(busiest[i]);
 
     for (i = 0; i < symbols.size(); ++ i)
     {
-        cerr << "# alloc: " << symbols[i]->type() << " " << symbols[i]->name() << "\t\t:= " << symbols[i]->type().size() << " bytes" << endl;
-        if (symbols[i]->_offset == 0) 
+        if (trace != nullptr)
+            *trace << "# alloc: " << symbols[i]->type() << " " << symbols[i]->name() << "\t\t:= " << symbols[i]->type().size() << " bytes" << endl;
+        if (symbols[i]->_offset == 0 && symbols[i]->_register == nullptr) 
         {
             offset -= symbols[i]->type().size();
             symbols[i]->_offset = offset;
@@ -138,57 +118,43 @@ void Block::allocate(int& offset) const
 
     saved = offset;
 
-    for (i = 0; i < _stmts.size(); ++ i) 
+    for (i = 0; i < block.count(); ++ i) 
     {
         temp = saved;
-        _stmts[i]->allocate(temp);
+        block.child(i).allocate(temp);
         offset = min(offset, temp);
     }
 }
 
 
 /*
- * Function:	While::allocate
- *
- * Description:	Allocate storage for this while statement, which
- *		essentially means allocating storage for variables declared
- *		as part of its statement.
- */
-
-void While::allocate(int& offset) const
-{
-    _stmt->allocate(offset);
-}
-
-
-/*
- * Function:	If::allocate
+ * Function:	allocate_if (private)
  *
- * Description:	Allocate storage for this if-then or if-then-else
+ * Description:	Allocate storage for an if-then or if-then-else
  *		statement, which essentially means allocating storage for
  *		variables declared as part of its statements.
  */
 
-void If::allocate(int& offset) const
+static void allocate_if(Node stmt, int& offset)
 {
     int saved, temp;
 
     saved = offset;
-    _thenStmt->allocate(offset);
+    stmt.thenStmt().allocate(offset);
 
-    if (_elseStmt != nullptr) 
+    if (stmt.elseStmt()) 
     {
         temp = saved;
-        _elseStmt->allocate(temp);
+        stmt.elseStmt().allocate(temp);
         offset = min(offset, temp);
     }
 }
 
 
 /*
- * Function:	Function::allocate
+ * Function:	allocate_function (private)
  *
- * Description:	Allocate storage for this function and return the number of
+ * Description:	Allocate storage for a function and return the number of
  *		bytes required.  The parameters are allocated offsets as
  *		well, starting with the given offset.  This function is
  *		designed to work with both 32-bit and 64-bit Intel
@@ -201,15 +167,19 @@ void If::allocate(int& offset) const
  *		64-bit Intel/Linux:
  *		  SIZEOF_PARAM = 8 (each parameter is always eight bytes)
  *		  NUM_PARAM_REGS = 6 (first six parameters are in registers)
+ *
+ *		The parameters passed in registers are declared first in
+ *		the body, so they are allocated along with its variables
+ *		and compete with them to be kept in registers.
  */
 
-void Function::allocate(int& offset) const
+static void allocate_function(Node function, int& offset)
 {
-    Parameters *params;
+    const Parameters *params;
     Symbols symbols;
 
-    params = _id->type().parameters();
-    symbols = _body->declarations()->symbols();
+    params = function.symbol()->type().parameters();
+    symbols = function.body().declarations()->symbols();
 
     for (unsigned i = NUM_PARAM_REGS; i < params->size(); ++ i) 
     {
@@ -218,15 +188,40 @@ void Function::allocate(int& offset) const
     }
 
     offset = 0;
+    function.body().allocate(offset);
+}
 
-    for (unsigned i = 0; i < NUM_PARAM_REGS; ++ i)
-        if (i < params->size()) 
-        {
-            offset -= (*params)[i].promote().size();
-            symbols[i]->_offset = offset;
-        }
-        else
+
+/*
+ * Function:	Node::allocate
+ *
+ * Description:	Allocate storage for this node.  Only a block declares
+ *		anything, so only the statements that may contain one need
+ *		to do any work.  A while statement essentially allocates
+ *		storage for variables declared as part of its statement.
+ */
+
+void Node::allocate(int& offset) const
+{
+    switch (kind())
+    {
+        case BLOCK:
+            allocate_block(*this, offset);
             break;
 
-    _body->allocate(offset);
+        case WHILE:
+            stmt().allocate(offset);
+            break;
+
+        case IF:
+            allocate_if(*this, offset);
+            break;
+
+        case FUNCTION:
+            allocate_function(*this, offset);
+            break;
+
+        default:
+            break;
+    }
 }
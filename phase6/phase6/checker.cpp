@@ -21,9 +21,10 @@
 
 using namespace std;
 
-static map<string,Scope *> fields;
-static Scope *outermost, *toplevel;
-static const Type error, integer("int"), longInteger("long");
+static thread_local map<Atom,Scope *> fields;
+static thread_local vector<StructLayout *> layouts;
+static thread_local Scope *outermost, *toplevel;
+static const Type error, integer(intAtom), longInteger(longAtom);
 
 static string undeclared = "'%s' undeclared";
 static string redefined = "redefinition of '%s'";
@@ -52,12 +53,12 @@ static string incomplete_type = "using pointer to incomplete type";
  *		operator.
  */
 
-static Type promote(Expression *&expr)
+static Type promote(Node &expr)
 {
-    if (expr->type().isArray())
-	expr = new Address(expr, expr->type().promote());
+    if (expr.type().isArray())
+	expr = Node::Unary(Node::ADDRESS, expr, expr.type().promote());
 
-    return expr->type();
+    return expr.type();
 }
 
 
@@ -67,20 +68,19 @@ static Type promote(Expression *&expr)
  * Description:	Cast the given expression to the given type by inserting a
  *		cast operation.  As an optimization, an integer can always
  *		be converted to a long integer without an explicit cast.
+ *		The number it replaces is simply left unused in the pool.
  */
 
-static Expression *cast(Expression *expr, const Type &type)
+static Node cast(Node expr, const Type &type)
 {
     unsigned long value;
 
 
-    if (expr->isNumber(value))
-	if (expr->type() == integer && type == longInteger) {
-	    delete expr;
-	    return new Number(value);
-	}
+    if (expr.isNumber(value))
+	if (expr.type() == integer && type == longInteger)
+	    return Node::Number(value);
 
-    return new Cast(expr, type);
+    return Node::Unary(Node::CAST, expr, type);
 }
 
 
@@ -93,9 +93,9 @@ static Expression *cast(Expression *expr, const Type &type)
  *		necessary.
  */
 
-static Type extend(Expression *&expr, const Type &type)
+static Type extend(Node &expr, const Type &type)
 {
-    if (expr->type() == integer && type == longInteger)
+    if (expr.type() == integer && type == longInteger)
 	expr = cast(expr, type);
 
     return promote(expr);
@@ -109,10 +109,10 @@ static Type extend(Expression *&expr, const Type &type)
  *		assignment.  Promotion is also performed, if necessary.
  */
 
-static Type convert(Expression *&expr, const Type &type)
+static Type convert(Node &expr, const Type &type)
 {
 
-    if (expr->type() != type && expr->type().isNumeric() && type.isNumeric())
+    if (expr.type() != type && expr.type().isNumeric() && type.isNumeric())
 	expr = cast(expr, type);
 
     return promote(expr);
@@ -122,21 +122,20 @@ static Type convert(Expression *&expr, const Type &type)
 /*
  * Function:	scale
  *
- * Description:	Scale the result of pointer arithmetic.
+ * Description:	Scale the result of pointer arithmetic.  A number is
+ *		replaced by the scaled number, as in cast().
  */
 
-static Expression *scale(Expression *expr, unsigned size)
+static Node scale(Node expr, unsigned size)
 {
     unsigned long value;
 
 
-    if (expr->isNumber(value)) {
-	delete expr;
-	return new Number(value * size);
-    }
+    if (expr.isNumber(value))
+	return Node::Number(value * size);
 
     extend(expr, longInteger);
-    return new Multiply(expr, new Number(size), longInteger);
+    return Node::Binary(Node::MULTIPLY, expr, Node::Number(size), longInteger);
 }
 
 
@@ -164,7 +163,7 @@ static bool isIncompletePointer(const Type &t)
  *		fields have been defined.
  */
 
-static Type checkIfComplete(const string &name, const Type &type)
+static Type checkIfComplete(const Atom &name, const Type &type)
 {
     if (!type.isStruct() || type.indirection() > 0)
 	return type;
@@ -172,7 +171,7 @@ static Type checkIfComplete(const string &name, const Type &type)
     if (fields.count(type.specifier()) > 0)
 	return type;
 
-    report(incomplete, name);
+    report(incomplete, name.str());
     return error;
 }
 
@@ -183,16 +182,58 @@ static Type checkIfComplete(const string &name, const Type &type)
  * Description:	Check if the given type is a structure.
  */
 
-static Type checkIfStructure(const string &name, const Type &type)
+static Type checkIfStructure(const Atom &name, const Type &type)
 {
     if (!type.isStruct() || type.indirection() > 0)
 	return type;
 
-    report(nonpointer, name);
+    report(nonpointer, name.str());
     return type;
 }
 
 
+/*
+ * Function:	deleteScope (private)
+ *
+ * Description:	Delete the given scope and the symbols declared in it.
+ */
+
+static void deleteScope(Scope *scope)
+{
+    const Symbols &symbols = scope->symbols();
+
+    for (unsigned i = 0; i < symbols.size(); i ++)
+	delete symbols[i];
+
+    delete scope;
+}
+
+
+/*
+ * Function:	resetChecker
+ *
+ * Description:	Delete all scopes and structures, so that a new program can
+ *		be checked, and so that nothing is left behind once the
+ *		last program on a thread has been compiled.
+ */
+
+void resetChecker()
+{
+    for (unsigned i = 0; i < layouts.size(); i ++)
+	delete layouts[i];
+
+    for (auto &entry : fields)
+	deleteScope(entry.second);
+
+    if (outermost != nullptr)
+	deleteScope(outermost);
+
+    fields.clear();
+    layouts.clear();
+    outermost = toplevel = nullptr;
+}
+
+
 /*
  * Function:	openScope
  *
@@ -233,27 +274,87 @@ Scope *closeScope()
  *		structure with the same name is already defined, delete it.
  */
 
-void openStruct(const string &name)
+void openStruct(const Atom &name)
 {
     if (fields.count(name) > 0) {
-	delete fields[name];
+	deleteScope(fields[name]);
 	fields.erase(name);
-	report(redefined, name);
+	delete layouts[name.index()];
+	layouts[name.index()] = nullptr;
+	report(redefined, name.str());
     }
 
     openScope();
 }
 
 
+/*
+ * Function:	layoutStruct (private)
+ *
+ * Description:	Return the layout of a structure with the given fields.
+ *		Each field is aligned, and so is the entire structure,
+ *		whose alignment is the maximum alignment of its fields.
+ *		Each field symbol is also given its offset.  A field with
+ *		an incomplete type has already been reported and has the
+ *		error type, so it simply takes up no space.
+ */
+
+static StructLayout *layoutStruct(const Symbols &symbols)
+{
+    StructLayout *layout = new StructLayout();
+    unsigned long size = 0;
+    unsigned align, alignment = 1;
+
+
+    for (unsigned i = 0; i < symbols.size(); i ++) {
+	const Type &t = symbols[i]->type();
+
+	if (!t.isError()) {
+	    align = t.alignment();
+
+	    if (size % align != 0)
+		size += align - size % align;
+
+	    if (align > alignment)
+		alignment = align;
+	}
+
+	symbols[i]->_offset = size;
+	layout->offsets.push_back(size);
+
+	if (!t.isError())
+	    size += t.size();
+    }
+
+    if (size % alignment != 0)
+	size += alignment - size % alignment;
+
+    layout->size = size;
+    layout->alignment = alignment;
+    return layout;
+}
+
+
 /*
  * Function:	closeStruct
  *
- * Description:	Close the scope for the structure with the specified name.
+ * Description:	Close the scope for the structure with the specified name,
+ *		and compute its layout now that all of its fields are known.
+ *		Layouts are indexed by the atom of the structure's name, so
+ *		finding one never needs a search.
  */
 
-void closeStruct(const string &name)
+void closeStruct(const Atom &name)
 {
-    fields[name] = closeScope();
+    Scope *scope = closeScope();
+
+
+    fields[name] = scope;
+
+    if (layouts.size() <= name.index())
+	layouts.resize(name.index() + 1, nullptr);
+
+    layouts[name.index()] = layoutStruct(scope->symbols());
 }
 
 
@@ -263,13 +364,26 @@ void closeStruct(const string &name)
  * Description:	Return the fields associated with the specified structure.
  */
 
-Scope *getFields(const string &name)
+Scope *getFields(const Atom &name)
 {
     assert(fields.count(name) > 0);
     return fields[name];
 }
 
 
+/*
+ * Function:	getLayout
+ *
+ * Description:	Return the layout of the specified structure.
+ */
+
+const StructLayout *getLayout(const Atom &name)
+{
+    assert(name.index() < layouts.size() && layouts[name.index()] != nullptr);
+    return layouts[name.index()];
+}
+
+
 /*
  * Function:	defineFunction
  *
@@ -279,24 +393,26 @@ Scope *getFields(const string &name)
  *		declaration.
  */
 
-Symbol *defineFunction(const string &name, const Type &type)
+Symbol *defineFunction(const Atom &name, const Type &type)
 {
-    Symbol *symbol = outermost->find(name);
+    Symbol *previous = outermost->find(name);
+    Symbol *symbol;
 
-    if (symbol != nullptr) {
-	if (symbol->type().isFunction() && symbol->type().parameters()) {
-	    report(redefined, name);
-	    delete symbol->type().parameters();
+    if (previous != nullptr) {
+	if (previous->type().isFunction() && previous->type().parameters()) {
+	    report(redefined, name.str());
 
-	} else if (type != symbol->type())
-	    report(conflicting, name);
-
-	outermost->remove(name);
-	delete symbol;
+	} else if (type != previous->type())
+	    report(conflicting, name.str());
     }
 
     symbol = new Symbol(name, checkIfStructure(name, type));
-    outermost->insert(symbol);
+
+    if (previous != nullptr) {
+	outermost->replace(symbol);
+	delete previous;
+    } else
+	outermost->insert(symbol);
 
     return symbol;
 }
@@ -310,7 +426,7 @@ Symbol *defineFunction(const string &name, const Type &type)
  *		redeclaration is discarded.
  */
 
-Symbol *declareFunction(const string &name, const Type &type)
+Symbol *declareFunction(const Atom &name, const Type &type)
 {
     Symbol *symbol = outermost->find(name);
 
@@ -318,10 +434,8 @@ Symbol *declareFunction(const string &name, const Type &type)
 	symbol = new Symbol(name, checkIfStructure(name, type));
 	outermost->insert(symbol);
 
-    } else if (type != symbol->type()) {
-	report(conflicting, name);
-	delete type.parameters();
-    }
+    } else if (type != symbol->type())
+	report(conflicting, name.str());
 
     return symbol;
 }
@@ -336,7 +450,7 @@ Symbol *declareFunction(const string &name, const Type &type)
  *		cannot be a structure type.
  */
 
-Symbol *declareParameter(const string &name, const Type &type)
+Symbol *declareParameter(const Atom &name, const Type &type)
 {
     return declareVariable(name, checkIfStructure(name, type));
 }
@@ -349,7 +463,7 @@ Symbol *declareParameter(const string &name, const Type &type)
  *		redeclaration is discarded.
  */
 
-Symbol *declareVariable(const string &name, const Type &type)
+Symbol *declareVariable(const Atom &name, const Type &type)
 {
     Symbol *symbol = toplevel->find(name);
 
@@ -358,10 +472,10 @@ Symbol *declareVariable(const string &name, const Type &type)
 	toplevel->insert(symbol);
 
     } else if (outermost != toplevel)
-	report(redeclared, name);
+	report(redeclared, name.str());
 
     else if (type != symbol->type())
-	report(conflicting, name);
+	report(conflicting, name.str());
 
     return symbol;
 }
@@ -375,12 +489,12 @@ Symbol *declareVariable(const string &name, const Type &type)
  *		future error messages.
  */
 
-Symbol *checkIdentifier(const string &name)
+Symbol *checkIdentifier(const Atom &name)
 {
     Symbol *symbol = toplevel->lookup(name);
 
     if (symbol == nullptr) {
-	report(undeclared, name);
+	report(undeclared, name.str());
 	symbol = new Symbol(name, error);
 	toplevel->insert(symbol);
     }
@@ -397,10 +511,10 @@ Symbol *checkIdentifier(const string &name)
  *		of the arguments must agree.
  */
 
-Expression *checkCall(Symbol *id, Expressions &args)
+Node checkCall(Symbol *id, Expressions &args)
 {
     const Type &t = id->type();
-    Parameters *params;
+    const Parameters *params;
     Type arg, result = error;
 
 
@@ -438,7 +552,7 @@ Expression *checkCall(Symbol *id, Expressions &args)
 	    report(invalid_function);
     }
 
-    return new Call(id, args, result);
+    return Node::Call(id, args, result);
 }
 
 
@@ -451,10 +565,10 @@ Expression *checkCall(Symbol *id, Expressions &args)
  *		The pointer type must be complete.
  */
 
-Expression *checkArray(Expression *left, Expression *right)
+Node checkArray(Node left, Node right)
 {
-    Type t1 = left->type();
-    Type t2 = right->type();
+    Type t1 = left.type();
+    Type t2 = right.type();
     Type result = error;
 
 
@@ -471,7 +585,7 @@ Expression *checkArray(Expression *left, Expression *right)
 	    report(invalid_operands, "[]");
     }
 
-    return new Dereference(new Add(left, right, t1), result);
+    return Node::Unary(Node::DEREFERENCE, Node::Binary(Node::ADD, left, right, t1), result);
 }
 
 
@@ -486,9 +600,9 @@ Expression *checkArray(Expression *left, Expression *right)
  *		type, so we only get the error once.
  */
 
-Expression *checkDirectField(Expression *expr, const std::string &id)
+Node checkDirectField(Node expr, const Atom &id)
 {
-    const Type &t = expr->type();
+    const Type &t = expr.type();
     Symbol *symbol = nullptr;
 
 
@@ -507,9 +621,9 @@ Expression *checkDirectField(Expression *expr, const std::string &id)
     }
 
     if (symbol == nullptr)
-	symbol = new Symbol("-unknown-", error);
+	symbol = new Symbol(Atom("-unknown-"), error);
 
-    return new Field(expr, symbol, symbol->type());
+    return Node::Field(expr, symbol, symbol->type());
 }
 
 
@@ -525,7 +639,7 @@ Expression *checkDirectField(Expression *expr, const std::string &id)
  *		type, so we only get the error once.
  */
 
-Expression *checkIndirectField(Expression *expr, const std::string &id)
+Node checkIndirectField(Node expr, const Atom &id)
 {
     Type t = promote(expr);
     Symbol *symbol = nullptr;
@@ -550,9 +664,9 @@ Expression *checkIndirectField(Expression *expr, const std::string &id)
     }
 
     if (symbol == nullptr)
-	symbol = new Symbol("-unknown-", error);
+	symbol = new Symbol(Atom("-unknown-"), error);
 
-    return new Field(new Dereference(expr, t), symbol, symbol->type());
+    return Node::Field(Node::Unary(Node::DEREFERENCE, expr, t), symbol, symbol->type());
 }
 
 
@@ -563,7 +677,7 @@ Expression *checkIndirectField(Expression *expr, const std::string &id)
  *		must have a scalar type, and the result has type int.
  */
 
-Expression *checkNot(Expression *expr)
+Node checkNot(Node expr)
 {
     const Type &t = promote(expr);
     Type result = error;
@@ -576,7 +690,7 @@ Expression *checkNot(Expression *expr)
 	    report(invalid_operand, "!");
     }
 
-    return new Not(expr, result);
+    return Node::Unary(Node::NOT, expr, result);
 }
 
 
@@ -588,9 +702,9 @@ Expression *checkNot(Expression *expr)
  *		same type.
  */
 
-Expression *checkNegate(Expression *expr)
+Node checkNegate(Node expr)
 {
-    const Type &t = expr->type();
+    const Type &t = expr.type();
     Type result = error;
 
 
@@ -601,7 +715,7 @@ Expression *checkNegate(Expression *expr)
 	    report(invalid_operand, "-");
     }
 
-    return new Negate(expr, result);
+    return Node::Unary(Node::NEGATE, expr, result);
 }
 
 
@@ -613,7 +727,7 @@ Expression *checkNegate(Expression *expr)
  *		result has type T.
  */
 
-Expression *checkDereference(Expression *expr)
+Node checkDereference(Node expr)
 {
     const Type &t = promote(expr);
     Type result = error;
@@ -628,7 +742,7 @@ Expression *checkDereference(Expression *expr)
 	    report(invalid_operand, "*");
     }
 
-    return new Dereference(expr, result);
+    return Node::Unary(Node::DEREFERENCE, expr, result);
 }
 
 
@@ -637,23 +751,28 @@ Expression *checkDereference(Expression *expr)
  *
  * Description:	Check an address expression: & expr.  The operand must be
  *		an lvalue, and if it has type T, then the result has type
- *		"pointer to T."
+ *		"pointer to T."  A variable whose address is taken escapes
+ *		and must be kept in memory.
  */
 
-Expression *checkAddress(Expression *expr)
+Node checkAddress(Node expr)
 {
-    const Type &t = expr->type();
+    const Type &t = expr.type();
     Type result = error;
+    Symbol *symbol;
 
 
     if (t != error) {
-	if (expr->lvalue())
+	if (expr.lvalue())
 	    result = Type(t.specifier(), t.indirection() + 1);
 	else
 	    report(invalid_lvalue);
     }
 
-    return new Address(expr, result);
+    if (expr.isIdentifier(symbol))
+	symbol->_escapes = true;
+
+    return Node::Unary(Node::ADDRESS, expr, result);
 }
 
 
@@ -664,16 +783,16 @@ Expression *checkAddress(Expression *expr)
  *		be a function type.
  */
 
-Expression *checkSizeof(Expression *expr)
+Node checkSizeof(Node expr)
 {
-    const Type &t = expr->type();
+    const Type &t = expr.type();
 
 
     if (t != error && !t.isFunction())
-	return new Number(expr->type().size());
+	return Node::Number(expr.type().size());
 
     report(invalid_sizeof);
-    return new Number(0);
+    return Node::Number(0);
 }
 
 
@@ -685,7 +804,7 @@ Expression *checkSizeof(Expression *expr)
  *		pointer types after any promotion.
  */
 
-Expression *checkCast(const Type &type, Expression *expr)
+Node checkCast(const Type &type, Node expr)
 {
     const Type &t = promote(expr);
 
@@ -694,13 +813,13 @@ Expression *checkCast(const Type &type, Expression *expr)
 	return expr;
 
     if (type.isNumeric() && t.isNumeric())
-	return new Cast(expr, type);
+	return Node::Unary(Node::CAST, expr, type);
 
     if (type.isPointer() && t.isPointer())
-	return new Cast(expr, type);
+	return Node::Unary(Node::CAST, expr, type);
 
     report(invalid_cast);
-    return new Cast(expr, error);
+    return Node::Unary(Node::CAST, expr, error);
 }
 
 
@@ -713,11 +832,11 @@ Expression *checkCast(const Type &type, Expression *expr)
  *		otherwise.
  */
 
-static Type checkMultiplicative(Expression *&left, Expression *&right,
+static Type checkMultiplicative(Node &left, Node &right,
 	const string &op)
 {
-    const Type &t1 = extend(left, right->type());
-    const Type &t2 = extend(right, left->type());
+    const Type &t1 = extend(left, right.type());
+    const Type &t2 = extend(right, left.type());
     Type result = error;
 
 
@@ -738,10 +857,10 @@ static Type checkMultiplicative(Expression *&left, Expression *&right,
  * Description:	Check a multiplication expression: left * right.
  */
 
-Expression *checkMultiply(Expression *left, Expression *right)
+Node checkMultiply(Node left, Node right)
 {
     Type t = checkMultiplicative(left, right, "*");
-    return new Multiply(left, right, t);
+    return Node::Binary(Node::MULTIPLY, left, right, t);
 }
 
 
@@ -751,10 +870,10 @@ Expression *checkMultiply(Expression *left, Expression *right)
  * Description:	Check a division expression: left / right.
  */
 
-Expression *checkDivide(Expression *left, Expression *right)
+Node checkDivide(Node left, Node right)
 {
     Type t = checkMultiplicative(left, right, "/");
-    return new Divide(left, right, t);
+    return Node::Binary(Node::DIVIDE, left, right, t);
 }
 
 /*
@@ -763,10 +882,10 @@ Expression *checkDivide(Expression *left, Expression *right)
  * Description:	Check a remainder expression: left % right.
  */
 
-Expression *checkRemainder(Expression *left, Expression *right)
+Node checkRemainder(Node left, Node right)
 {
     Type t = checkMultiplicative(left, right, "%");
-    return new Remainder(left, right, t);
+    return Node::Binary(Node::REMAINDER, left, right, t);
 }
 
 
@@ -781,10 +900,10 @@ Expression *checkRemainder(Expression *left, Expression *right)
  *		type must be complete.
  */
 
-Expression *checkAdd(Expression *left, Expression *right)
+Node checkAdd(Node left, Node right)
 {
-    Type t1 = left->type();
-    Type t2 = right->type();
+    Type t1 = left.type();
+    Type t2 = right.type();
     Type result = error;
 
 
@@ -811,7 +930,7 @@ Expression *checkAdd(Expression *left, Expression *right)
 	    report(invalid_operands, "+");
     }
 
-    return new Add(left, right, result);
+    return Node::Binary(Node::ADD, left, right, result);
 }
 
 
@@ -827,11 +946,11 @@ Expression *checkAdd(Expression *left, Expression *right)
  *		has type long.  Any pointer type must be complete.
  */
 
-Expression *checkSubtract(Expression *left, Expression *right)
+Node checkSubtract(Node left, Node right)
 {
-    Expression *tree;
-    Type t1 = left->type();
-    Type t2 = right->type();
+    Node tree;
+    Type t1 = left.type();
+    Type t2 = right.type();
     Type result = error;
 
 
@@ -858,10 +977,10 @@ Expression *checkSubtract(Expression *left, Expression *right)
 	    report(invalid_operands, "-");
     }
 
-    tree = new Subtract(left, right, result);
+    tree = Node::Binary(Node::SUBTRACT, left, right, result);
 
     if (t1.isPointer() && t1 == t2)
-	tree = new Divide(tree, new Number(t1.deref().size()), longInteger);
+	tree = Node::Binary(Node::DIVIDE, tree, Node::Number(t1.deref().size()), longInteger);
 
     return tree;
 }
@@ -875,11 +994,11 @@ Expression *checkSubtract(Expression *left, Expression *right)
  *		int.
  */
 
-static Type checkComparative(Expression *&left, Expression *&right,
+static Type checkComparative(Node &left, Node &right,
 	const string &op)
 {
-    const Type &t1 = extend(left, right->type());
-    const Type &t2 = extend(right, left->type());
+    const Type &t1 = extend(left, right.type());
+    const Type &t2 = extend(right, left.type());
     Type result = error;
 
 
@@ -900,10 +1019,10 @@ static Type checkComparative(Expression *&left, Expression *&right,
  * Description:	Check an equality expression: left == right.
  */
 
-Expression *checkEqual(Expression *left, Expression *right)
+Node checkEqual(Node left, Node right)
 {
     Type t = checkComparative(left, right, "==");
-    return new Equal(left, right, t);
+    return Node::Binary(Node::EQUAL, left, right, t);
 }
 
 
@@ -913,10 +1032,10 @@ Expression *checkEqual(Expression *left, Expression *right)
  * Description:	Check an inequality expression: left != right.
  */
 
-Expression *checkNotEqual(Expression *left, Expression *right)
+Node checkNotEqual(Node left, Node right)
 {
     Type t = checkComparative(left, right, "!=");
-    return new NotEqual(left, right, t);
+    return Node::Binary(Node::NOT_EQUAL, left, right, t);
 }
 
 
@@ -926,10 +1045,10 @@ Expression *checkNotEqual(Expression *left, Expression *right)
  * Description:	Check a less-than expression: left < right.
  */
 
-Expression *checkLessThan(Expression *left, Expression *right)
+Node checkLessThan(Node left, Node right)
 {
     Type t = checkComparative(left, right, "<");
-    return new LessThan(left, right, t);
+    return Node::Binary(Node::LESS_THAN, left, right, t);
 }
 
 
@@ -939,10 +1058,10 @@ Expression *checkLessThan(Expression *left, Expression *right)
  * Description:	Check a greater-than expression: left > right.
  */
 
-Expression *checkGreaterThan(Expression *left, Expression *right)
+Node checkGreaterThan(Node left, Node right)
 {
     Type t = checkComparative(left, right, ">");
-    return new GreaterThan(left, right, t);
+    return Node::Binary(Node::GREATER_THAN, left, right, t);
 }
 
 
@@ -952,10 +1071,10 @@ Expression *checkGreaterThan(Expression *left, Expression *right)
  * Description:	Check a less-than-or-equal expression: left <= right.
  */
 
-Expression *checkLessOrEqual(Expression *left, Expression *right)
+Node checkLessOrEqual(Node left, Node right)
 {
     Type t = checkComparative(left, right, "<=");
-    return new LessOrEqual(left, right, t);
+    return Node::Binary(Node::LESS_OR_EQUAL, left, right, t);
 }
 
 
@@ -965,10 +1084,10 @@ Expression *checkLessOrEqual(Expression *left, Expression *right)
  * Description:	Check a greater-than-or-equal expression: left >= right.
  */
 
-Expression *checkGreaterOrEqual(Expression *left, Expression *right)
+Node checkGreaterOrEqual(Node left, Node right)
 {
     Type t = checkComparative(left, right, ">=");
-    return new GreaterOrEqual(left, right, t);
+    return Node::Binary(Node::GREATER_OR_EQUAL, left, right, t);
 }
 
 
@@ -980,7 +1099,7 @@ Expression *checkGreaterOrEqual(Expression *left, Expression *right)
  *		type int.
  */
 
-static Type checkLogical(Expression *&left, Expression *&right,
+static Type checkLogical(Node &left, Node &right,
 	const string &op)
 {
     const Type &t1 = promote(left);
@@ -1005,10 +1124,10 @@ static Type checkLogical(Expression *&left, Expression *&right,
  * Description:	Check a logical-and expression: left && right.
  */
 
-Expression *checkLogicalAnd(Expression *left, Expression *right)
+Node checkLogicalAnd(Node left, Node right)
 {
     Type t = checkLogical(left, right, "&&");
-    return new LogicalAnd(left, right, t);
+    return Node::Binary(Node::LOGICAL_AND, left, right, t);
 }
 
 
@@ -1018,10 +1137,10 @@ Expression *checkLogicalAnd(Expression *left, Expression *right)
  * Description:	Check a logical-or expression: left || right.
  */
 
-Expression *checkLogicalOr(Expression *left, Expression *right)
+Node checkLogicalOr(Node left, Node right)
 {
     Type t = checkLogical(left, right, "||");
-    return new LogicalOr(left, right, t);
+    return Node::Binary(Node::LOGICAL_OR, left, right, t);
 }
 
 
@@ -1032,21 +1151,21 @@ Expression *checkLogicalOr(Expression *left, Expression *right)
  *		lvalue and the types of the operands must be compatible.
  */
 
-Statement *checkAssignment(Expression *left, Expression *right)
+Node checkAssignment(Node left, Node right)
 {
-    const Type &t1 = left->type();
-    const Type &t2 = convert(right, left->type());
+    const Type &t1 = left.type();
+    const Type &t2 = convert(right, left.type());
 
 
     if (t1 != error && t2 != error) {
-	if (!left->lvalue())
+	if (!left.lvalue())
 	    report(invalid_lvalue);
 
 	else if (!t1.isCompatibleWith(t2))
 	    report(invalid_operands, "=");
     }
 
-    return new Assignment(left, right);
+    return Node::Assignment(left, right);
 }
 
 
@@ -1058,7 +1177,7 @@ Statement *checkAssignment(Expression *left, Expression *right)
  *		return type of the enclosing function.
  */
 
-void checkReturn(Expression *&expr, const Type &type)
+void checkReturn(Node &expr, const Type &type)
 {
     const Type &t = convert(expr, type);
 
@@ -1076,7 +1195,7 @@ void checkReturn(Expression *&expr, const Type &type)
  *		statement: the type must be a scalar type.
  */
 
-void checkTest(Expression *&expr)
+void checkTest(Node &expr)
 {
     const Type &t = promote(expr);
 
@@ -3,53 +3,67 @@
  *
  * Description:	This file contains the public function declarations for the
  *		semantic checker for Simple C.
+ *
+ *		The layout of a structure is computed once its fields have
+ *		all been declared.  The offsets of the fields are indexed by
+ *		their position in the scope of the structure.
  */
 
 # ifndef CHECKER_H
 # define CHECKER_H
-# include <string>
+# include <vector>
+# include "Atom.h"
 # include "Scope.h"
 # include "Tree.h"
 
+struct StructLayout {
+    unsigned long size;
+    unsigned alignment;
+    std::vector<unsigned long> offsets;
+};
+
+void resetChecker();
+
 Scope *openScope();
 Scope *closeScope();
 
-void openStruct(const std::string &name);
-void closeStruct(const std::string &name);
-Scope *getFields(const std::string &name);
-
-Symbol *defineFunction(const std::string &name, const Type &type);
-Symbol *declareFunction(const std::string &name, const Type &type);
-Symbol *declareParameter(const std::string &name, const Type &type);
-Symbol *declareVariable(const std::string &name, const Type &type);
-Symbol *checkIdentifier(const std::string &name);
-
-Expression *checkCall(Symbol *id, Expressions &args);
-Expression *checkArray(Expression *left, Expression *right);
-Expression *checkDirectField(Expression *expr, const std::string &id);
-Expression *checkIndirectField(Expression *expr, const std::string &id);
-Expression *checkNot(Expression *expr);
-Expression *checkNegate(Expression *expr);
-Expression *checkDereference(Expression *expr);
-Expression *checkAddress(Expression *expr);
-Expression *checkSizeof(Expression *expr);
-Expression *checkCast(const Type &type, Expression *expr);
-Expression *checkMultiply(Expression *left, Expression *right);
-Expression *checkDivide(Expression *left, Expression *right);
-Expression *checkRemainder(Expression *left, Expression *right);
-Expression *checkAdd(Expression *left, Expression *right);
-Expression *checkSubtract(Expression *left, Expression *right);
-Expression *checkLessThan(Expression *left, Expression *right);
-Expression *checkGreaterThan(Expression *left, Expression *right);
-Expression *checkLessOrEqual(Expression *left, Expression *right);
-Expression *checkGreaterOrEqual(Expression *left, Expression *right);
-Expression *checkEqual(Expression *left, Expression *right);
-Expression *checkNotEqual(Expression *left, Expression *right);
-Expression *checkLogicalAnd(Expression *left, Expression *right);
-Expression *checkLogicalOr(Expression *left, Expression *right);
-Statement *checkAssignment(Expression *left, Expression *right);
-
-void checkReturn(Expression *&expr, const Type &type);
-void checkTest(Expression *&expr);
+void openStruct(const Atom &name);
+void closeStruct(const Atom &name);
+Scope *getFields(const Atom &name);
+const StructLayout *getLayout(const Atom &name);
+
+Symbol *defineFunction(const Atom &name, const Type &type);
+Symbol *declareFunction(const Atom &name, const Type &type);
+Symbol *declareParameter(const Atom &name, const Type &type);
+Symbol *declareVariable(const Atom &name, const Type &type);
+Symbol *checkIdentifier(const Atom &name);
+
+Node checkCall(Symbol *id, Expressions &args);
+Node checkArray(Node left, Node right);
+Node checkDirectField(Node expr, const Atom &id);
+Node checkIndirectField(Node expr, const Atom &id);
+Node checkNot(Node expr);
+Node checkNegate(Node expr);
+Node checkDereference(Node expr);
+Node checkAddress(Node expr);
+Node checkSizeof(Node expr);
+Node checkCast(const Type &type, Node expr);
+Node checkMultiply(Node left, Node right);
+Node checkDivide(Node left, Node right);
+Node checkRemainder(Node left, Node right);
+Node checkAdd(Node left, Node right);
+Node checkSubtract(Node left, Node right);
+Node checkLessThan(Node left, Node right);
+Node checkGreaterThan(Node left, Node right);
+Node checkLessOrEqual(Node left, Node right);
+Node checkGreaterOrEqual(Node left, Node right);
+Node checkEqual(Node left, Node right);
+Node checkNotEqual(Node left, Node right);
+Node checkLogicalAnd(Node left, Node right);
+Node checkLogicalOr(Node left, Node right);
+Node checkAssignment(Node left, Node right);
+
+void checkReturn(Node &expr, const Type &type);
+void checkTest(Node &expr);
 
 # endif /* CHECKER_H */
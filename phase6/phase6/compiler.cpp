@@ -0,0 +1,100 @@
+/*
+ * File:	compiler.cpp
+ *
+ * Description:	This file contains the public function definitions for the
+ *		Simple C compiler as a library.  Each compilation points the
+ *		per-thread output and diagnostic streams at its own streams
+ *		and then runs the parser, which does everything else.
+ */
+
+# include <sstream>
+# include "compiler.h"
+# include "checker.h"
+# include "generator.h"
+# include "lexer.h"
+# include "parser.h"
+# include "Tree.h"
+
+using namespace std;
+
+
+/*
+ * Function:	run (private)
+ *
+ * Description:	Compile the source that has already been opened, writing
+ *		the code and diagnostics to the given streams.  Return
+ *		false if the program was abandoned because of a syntax
+ *		error.  Either way, the trees, scopes, and symbols of the
+ *		program are deleted before we return, so that nothing is
+ *		left behind on a thread that compiles no more programs.
+ */
+
+static bool run(ostream &code, ostream &diags, const Options &options)
+{
+    bool complete = true;
+
+
+    output = &code;
+    diagnostics = &diags;
+    trace = options.trace ? &diags : nullptr;
+
+    try {
+	parse();
+    } catch (const SyntaxError &) {
+	complete = false;
+    }
+
+    Node::release();
+    resetChecker();
+    closeSource();
+    return complete;
+}
+
+
+/*
+ * Function:	compile
+ *
+ * Description:	Compile the program in the given buffer.
+ */
+
+Result compile(const char *text, size_t length, const Options &options)
+{
+    stringstream code, diags;
+    Result result;
+
+
+    openSource(text, length);
+    result.complete = run(code, diags, options);
+    result.errors = numerrors;
+    result.assembly = code.str();
+    result.diagnostics = diags.str();
+    return result;
+}
+
+
+/*
+ * Function:	compile
+ *
+ * Description:	Compile the program in the given string.
+ */
+
+Result compile(const string &source, const Options &options)
+{
+    return compile(source.data(), source.size(), options);
+}
+
+
+/*
+ * Function:	compile
+ *
+ * Description:	Compile the program in the file open on the given
+ *		descriptor, writing the code and diagnostics to the given
+ *		streams as they are produced.  Return false if there was a
+ *		syntax error.
+ */
+
+bool compile(int fd, ostream &code, ostream &diags, const Options &options)
+{
+    openSource(fd);
+    return run(code, diags, options);
+}
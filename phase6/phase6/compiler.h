@@ -0,0 +1,43 @@
+/*
+ * File:	compiler.h
+ *
+ * Description:	This file contains the public interface to the Simple C
+ *		compiler as a library.  A program is compiled entirely in
+ *		memory: the source is given as a buffer, and the assembly
+ *		code and the diagnostics are returned as strings.  Nothing
+ *		is read from the standard input or written to the standard
+ *		output or error.
+ *
+ *		The compiler may be called from any number of threads at
+ *		once, since each thread has compiler state of its own.
+ */
+
+# ifndef COMPILER_H
+# define COMPILER_H
+# include <cstddef>
+# include <ostream>
+# include <string>
+
+struct Options {
+    bool trace;		/* include the trees and storage allocation */
+
+    Options() : trace(false) {}
+};
+
+struct Result {
+    std::string assembly;
+    std::string diagnostics;
+    unsigned errors;	/* number of errors reported */
+    bool complete;	/* false if abandoned because of a syntax error */
+
+    bool succeeded() const { return complete && errors == 0; }
+};
+
+Result compile(const std::string &source, const Options &options = Options());
+Result compile(const char *text, std::size_t length,
+	const Options &options = Options());
+
+bool compile(int fd, std::ostream &code, std::ostream &diags,
+	const Options &options = Options());
+
+# endif /* COMPILER_H */
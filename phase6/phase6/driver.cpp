@@ -0,0 +1,179 @@
+/*
+ * File:	driver.cpp
+ *
+ * Description:	This file contains the main program for the Simple C
+ *		compiler.
+ *
+ *		The compiler itself is in the library, and this is just a
+ *		command line interface to it.  With no file arguments, the
+ *		standard input is compiled and the code is written to the
+ *		standard output.  Otherwise, each file named on the command
+ *		line is compiled separately, with the code for file.c
+ *		written to file.s.  The files are divided among a pool of
+ *		worker threads, one per processor unless given by the -j
+ *		option.  Since a worker keeps every piece of compiler state
+ *		to itself, the only thing the workers share is the next
+ *		file to compile and the standard error.  The diagnostics for
+ *		each file are collected separately and written all at once,
+ *		so those of different files never interleave.
+ */
+
+# include <atomic>
+# include <cerrno>
+# include <cstdlib>
+# include <cstring>
+# include <fstream>
+# include <iostream>
+# include <mutex>
+# include <sstream>
+# include <string>
+# include <thread>
+# include <vector>
+# include <fcntl.h>
+# include <unistd.h>
+# include "compiler.h"
+
+using namespace std;
+
+static vector<string> files;
+static atomic<unsigned> next_file(0);
+static atomic<bool> failed(false);
+static mutex stderr_lock;
+static Options options;
+
+
+/*
+ * Function:	assemblyName (private)
+ *
+ * Description:	Return the name of the assembly file for the given source
+ *		file, which replaces a trailing .c with .s, or otherwise
+ *		appends .s.
+ */
+
+static string assemblyName(const string &path)
+{
+    size_t n = path.size();
+
+    if (n > 2 && path.compare(n - 2, 2, ".c") == 0)
+	return path.substr(0, n - 2) + ".s";
+
+    return path + ".s";
+}
+
+
+/*
+ * Function:	compileFile (private)
+ *
+ * Description:	Compile the named file into its assembly file, and then
+ *		write its diagnostics to the standard error as a unit.
+ */
+
+static void compileFile(const string &path)
+{
+    stringstream diags;
+    string name = assemblyName(path);
+    int fd;
+
+
+    if ((fd = open(path.c_str(), O_RDONLY)) < 0) {
+	diags << path << ": " << strerror(errno) << endl;
+	failed = true;
+
+    } else {
+	ofstream code(name.c_str());
+
+	if (!code) {
+	    diags << name << ": cannot create file" << endl;
+	    failed = true;
+
+	} else if (!compile(fd, code, diags, options))
+	    failed = true;
+
+	close(fd);
+    }
+
+    lock_guard<mutex> guard(stderr_lock);
+    cerr << diags.str() << flush;
+}
+
+
+/*
+ * Function:	worker (private)
+ *
+ * Description:	Repeatedly compile the next file not yet taken by another
+ *		worker until there are none left.
+ */
+
+static void worker()
+{
+    unsigned i;
+
+    while ((i = next_file ++) < files.size())
+	compileFile(files[i]);
+}
+
+
+/*
+ * Function:	usage (private)
+ *
+ * Description:	Report how to run us and give up.
+ */
+
+static void usage(const char *program)
+{
+    cerr << "usage: " << program << " [-j jobs] [file.c ...]" << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Parse the command line and compile either the standard
+ *		input or each file given.
+ */
+
+int main(int argc, char *argv[])
+{
+    unsigned jobs = thread::hardware_concurrency();
+    vector<thread> workers;
+    int i;
+
+
+    options.trace = true;
+
+    for (i = 1; i < argc; i ++) {
+	if (strcmp(argv[i], "-j") == 0) {
+	    if (++ i == argc || (jobs = atoi(argv[i])) == 0)
+		usage(argv[0]);
+
+	} else if (strncmp(argv[i], "-j", 2) == 0) {
+	    if ((jobs = atoi(argv[i] + 2)) == 0)
+		usage(argv[0]);
+
+	} else if (argv[i][0] == '-')
+	    usage(argv[0]);
+
+	else
+	    files.push_back(argv[i]);
+    }
+
+    if (files.empty())
+	exit(compile(0, cout, cerr, options) ? EXIT_SUCCESS : EXIT_FAILURE);
+
+    if (jobs == 0)
+	jobs = 1;
+
+    if (jobs > files.size())
+	jobs = files.size();
+
+    for (unsigned j = 1; j < jobs; j ++)
+	workers.push_back(thread(worker));
+
+    worker();
+
+    for (unsigned j = 0; j < workers.size(); j ++)
+	workers[j].join();
+
+    exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,249 @@
+/*
+ * File:	exprbench.cpp
+ *
+ * Description:	This file contains the benchmark for parsing dense
+ *		expressions in Simple C.  It compiles programs entirely in
+ *		memory through the library, so nothing is read or written
+ *		but the report.
+ *
+ *		The corpus is generated from a seed: a number of functions,
+ *		each assigning random nested expressions over a handful of
+ *		variables, with every binary operator, negation and not,
+ *		casts, parentheses, and calls.  It is compiled whole to give the
+ *		throughput of the compiler on expression-dense code.  Then
+ *		single expressions nested thousands deep, as left and right
+ *		operand chains, parentheses, and calls, are compiled to
+ *		show that the time is linear in the depth.  Every program
+ *		must compile without errors, and one nested beyond the
+ *		limit must be rejected.  Each time is the best of several
+ *		runs.
+ *
+ *		usage: exprbench [functions [runs [seed]]]
+ */
+
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <string>
+# include "compiler.h"
+
+using namespace std;
+
+static unsigned long state;
+static volatile unsigned long sink;
+
+static const char *binary[] = {
+    "||", "&&", "==", "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%",
+};
+
+static const char *unary[] = {
+    "!", "- ", "(long) ", "(int) ",
+};
+
+
+/*
+ * Function:	next (private)
+ *
+ * Description:	Return a pseudo-random number less than the given bound.
+ */
+
+static unsigned next(unsigned bound)
+{
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    return (state >> 33) % bound;
+}
+
+
+/*
+ * Function:	expression (private)
+ *
+ * Description:	Append a random expression nested at most the given
+ *		depth to the program.
+ */
+
+static void expression(string &s, unsigned depth)
+{
+    unsigned n = (depth == 0 ? next(3) : next(12));
+
+
+    if (n == 0)
+	s += to_string(next(1000));
+
+    else if (n < 3)
+	s += (char) ('a' + next(8));
+
+    else if (n < 8) {
+	expression(s, depth - 1);
+	s += ' ';
+	s += binary[next(sizeof(binary) / sizeof(binary[0]))];
+	s += ' ';
+	expression(s, depth - 1);
+
+    } else if (n < 9) {
+	s += unary[next(sizeof(unary) / sizeof(unary[0]))];
+	expression(s, depth - 1);
+
+    } else if (n < 11) {
+	s += '(';
+	expression(s, depth - 1);
+	s += ')';
+
+    } else {
+	s += "p(";
+	expression(s, depth - 1);
+	s += ", ";
+	expression(s, depth - 1);
+	s += ')';
+    }
+}
+
+
+/*
+ * Function:	corpus (private)
+ *
+ * Description:	Return a program of the given number of functions, each
+ *		of forty assignments of random expressions.
+ */
+
+static string corpus(unsigned functions)
+{
+    string s = "int p(int x, int y) { return x - y; }\n";
+
+
+    for (unsigned i = 0; i < functions; i ++) {
+	s += "int g" + to_string(i) + "(int a, int b, int c, int d)\n{\n";
+	s += "    int e, f, g, h;\n";
+	s += "    e = a; f = b; g = c; h = d;\n";
+
+	for (unsigned j = 0; j < 40; j ++) {
+	    s += "    ";
+	    s += (char) ('a' + next(4));
+	    s += " = ";
+	    expression(s, 8);
+	    s += ";\n";
+	}
+
+	s += "    return a + b + c + d;\n}\n";
+    }
+
+    return s;
+}
+
+
+/*
+ * Function:	nested (private)
+ *
+ * Description:	Return a program with a single expression of the given
+ *		shape nested the given depth.
+ */
+
+static string nested(const string &shape, unsigned depth)
+{
+    string s = "int f(int x) { return x + 1; }\n"
+	"int main(void) { int x; x = 1; x = ";
+
+
+    for (unsigned i = 0; i < depth; i ++)
+	if (shape == "left")
+	    s += "x + ";
+	else if (shape == "right")
+	    s += "x + (";
+	else if (shape == "parentheses")
+	    s += "(";
+	else
+	    s += "f(";
+
+    s += "x";
+
+    if (shape != "left")
+	s += string(depth, ')');
+
+    return s + "; return x; }\n";
+}
+
+
+/*
+ * Function:	seconds (private)
+ *
+ * Description:	Return the current time in seconds.
+ */
+
+static double seconds()
+{
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/*
+ * Function:	best (private)
+ *
+ * Description:	Return the best time of the given number of runs of the
+ *		given function.
+ */
+
+template<class F>
+static double best(unsigned runs, F f)
+{
+    double start, t, min = 1e30;
+
+
+    for (unsigned i = 0; i < runs; i ++) {
+	start = seconds();
+	sink = f();
+	t = seconds() - start;
+
+	if (t < min)
+	    min = t;
+    }
+
+    return min;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *shapes[] = {"left", "right", "parentheses", "calls"};
+    unsigned functions, runs, failures = 0;
+    string source;
+    Result result;
+    double t;
+
+
+    functions = (argc > 1 ? atoi(argv[1]) : 300);
+    runs = (argc > 2 ? atoi(argv[2]) : 5);
+    state = (argc > 3 ? strtoul(argv[3], NULL, 0) : 175);
+
+    source = corpus(functions);
+    result = compile(source);
+
+    if (!result.succeeded()) {
+	printf("%s", result.diagnostics.c_str());
+	failures ++;
+    }
+
+    printf("%u functions in %lu bytes\n", functions, source.size());
+
+    t = best(runs, [&] { return compile(source).assembly.size(); });
+    printf("corpus\t\t%.3fs\t%.1f MB/s\n", t, source.size() / t / 1e6);
+
+    for (unsigned i = 0; i < 4; i ++)
+	for (unsigned depth = 1000; depth <= 4000; depth *= 2) {
+	    source = nested(shapes[i], depth);
+
+	    if (!compile(source).succeeded())
+		failures ++;
+
+	    t = best(runs, [&] { return compile(source).assembly.size(); });
+	    printf("%s %u\t%.3fs\t%.2f us/level\n", shapes[i], depth, t, t / depth * 1e6);
+	}
+
+    if (compile(nested("calls", 100000)).complete)
+	failures ++;
+
+    if (failures > 0) {
+	printf("%u programs compiled incorrectly\n", failures);
+	return 1;
+    }
+
+    return 0;
+}
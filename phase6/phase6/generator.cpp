@@ -4,11 +4,18 @@
  * Description:	This file contains the public and member function
  *		definitions for the code generator for Simple C.
  *
+ *		All of our state is kept per thread, so that several
+ *		programs can be compiled at once, and the code is written
+ *		to the output stream of the program being compiled.
+ *
  *		Extra functionality:
  *		- putting all the global declarations at the end
+ *		- keeping variables whose address is never taken in registers
  */
 
+# include <algorithm>
 # include <cassert>
+# include <climits>
 # include <iostream>
 # include <sstream>
 # include <vector>
@@ -20,18 +27,22 @@
 # include "Tree.h"
 
 using std::cerr;
-using std::cout;
 using std::endl;
 using std::ostream;
 using std::string;
 using std::stringstream;
+using std::swap;
 using std::vector;
 
-static int              offset;
+thread_local ostream*   output = &std::cout;
+
+static thread_local int              offset;
+static thread_local unsigned         position;
+static thread_local vector<int>      spill_slots;
 
-static string           func_name;
-static Label*           return_label;
-static vector<string>   strings;
+static thread_local string           func_name;
+static thread_local Label*           return_label;
+static thread_local vector<string>   strings;
 
 
 /* 0 disables debug command line outputs */
@@ -46,7 +57,7 @@ static vector<string>   strings;
 
 /* This shouid be set if we want to use the callee-saved registers. */
 
-# define CALLEE_SAVED 0
+# define CALLEE_SAVED 1
 
 
 /* The registers and their related functions */
@@ -54,40 +65,165 @@ static vector<string>   strings;
 typedef vector<Register*> Registers;
 
 
-static Register* rax    = new Register("%rax", "%eax", "%al");
-static Register* rbx    = new Register("%rbx", "%ebx", "%bl");
-static Register* rcx    = new Register("%rcx", "%ecx", "%cl");
-static Register* rdx    = new Register("%rdx", "%edx", "%dl");
-static Register* rsi    = new Register("%rsi", "%esi", "%sil");
-static Register* rdi    = new Register("%rdi", "%edi", "%dil");
-static Register* r8     = new Register("%r8", "%r8d", "%r8b");
-static Register* r9     = new Register("%r9", "%r9d", "%r9b");
-static Register* r10    = new Register("%r10", "%r10d", "%r10b");
-static Register* r11    = new Register("%r11", "%r11d", "%r11b");
-static Register* r12    = new Register("%r12", "%r12d", "%r12b");
-static Register* r13    = new Register("%r13", "%r13d", "%r13b");
-static Register* r14    = new Register("%r14", "%r14d", "%r14b");
-static Register* r15    = new Register("%r15", "%r15d", "%r15b");
-
-static Registers registers;
-static Registers parameters = { rdi, rsi, rdx, rcx, r8, r9 };
-static Registers caller_saved = { r11, r10, r9, r8, rcx, rdx, rsi, rdi, rax };
+/* The registers themselves, which belong to the thread and so are
+   destroyed when it exits */
+
+static thread_local Register machine[] = {
+    { "%rax", "%eax", "%al" },
+    { "%rbx", "%ebx", "%bl" },
+    { "%rcx", "%ecx", "%cl" },
+    { "%rdx", "%edx", "%dl" },
+    { "%rsi", "%esi", "%sil" },
+    { "%rdi", "%edi", "%dil" },
+    { "%r8", "%r8d", "%r8b" },
+    { "%r9", "%r9d", "%r9b" },
+    { "%r10", "%r10d", "%r10b" },
+    { "%r11", "%r11d", "%r11b" },
+    { "%r12", "%r12d", "%r12b" },
+    { "%r13", "%r13d", "%r13b" },
+    { "%r14", "%r14d", "%r14b" },
+    { "%r15", "%r15d", "%r15b" },
+};
+
+static thread_local Register* rax    = &machine[0];
+static thread_local Register* rbx    = &machine[1];
+static thread_local Register* rcx    = &machine[2];
+static thread_local Register* rdx    = &machine[3];
+static thread_local Register* rsi    = &machine[4];
+static thread_local Register* rdi    = &machine[5];
+static thread_local Register* r8     = &machine[6];
+static thread_local Register* r9     = &machine[7];
+static thread_local Register* r10    = &machine[8];
+static thread_local Register* r11    = &machine[9];
+static thread_local Register* r12    = &machine[10];
+static thread_local Register* r13    = &machine[11];
+static thread_local Register* r14    = &machine[12];
+static thread_local Register* r15    = &machine[13];
+
+static thread_local Registers registers;
+static thread_local Registers parameters = { rdi, rsi, rdx, rcx, r8, r9 };
+static thread_local Registers caller_saved = { r11, r10, r9, r8, rcx, rdx, rsi, rdi, rax };
 
 
 # if CALLEE_SAVED
-static Registers callee_saved = { rbx, r12, r13, r14, r15 };
+static thread_local Registers callee_saved = { rbx, r12, r13, r14, r15 };
 # else
-static Registers callee_saved = { };
+static thread_local Registers callee_saved = { };
 # endif
 
 
+/* The registers that may hold variables.  A function that makes no calls
+   can use the parameter registers it does not need, but any other
+   function must use the callee-saved registers and save them itself.
+   Neither %rax nor %rdx is ever used, since a division needs both. */
+
+static thread_local Registers leaf_homes = { rdi, rsi, rcx, r8, r9 };
+
+static thread_local Registers homes;
+static thread_local Registers variables;
+
+
+/* The callee-saved registers that the current function has used so far,
+   in the order in which it first used them. */
+
+static thread_local Registers touched;
+
+
+/* A memory operand of the form disp(base,index,scale), or a variable or
+   other object with a displacement.  Only a local variable can also be
+   indexed, since a global is addressed relative to %rip. */
+
+struct Location
+{
+    Node          object;
+    Node          base;
+    Node          index;
+    unsigned long scale = 1;
+    long          disp = 0;
+};
+
+
+/* A call in tail position jumps to a stub written after the epilogue,
+   once we know which registers must be restored and whether the frame
+   may be torn down at all.  The frame must stay if the address of
+   anything in it has been computed, since the callee might use it. */
+
+struct Tail
+{
+    Label         label;
+    const Symbol* callee;
+    const Label*  exit;
+};
+
+static thread_local vector<Tail>     tails;
+static thread_local bool             escaped;
+
+
+/* The code for branches predicted not to be taken, such as early returns,
+   which is written after the epilogue so that the likely path falls
+   through. */
+
+static thread_local vector<string>   cold;
+
+
 static int      align(int offset);
 static string   suffix(unsigned long size);
-static string   suffix(Expression* expr);
-
-Register*       get_reg();
-static void     assign(Expression* expr, Register* reg);
-static void     load(Expression* expr, Register* reg);
+static string   suffix(Node expr);
+
+Register*       get_reg(Node keep = Node());
+static void     assign(Node expr, Register* reg);
+static void     load(Node expr, Register* reg);
+static void     spill(Register* reg);
+static bool     recomputable(Node expr);
+static void     generate_operands(Node left, Node right);
+static bool     divide_constant(Node result, Node left, Node right, bool remainder);
+static bool     multiply_constant(Node result, Node left, Node right);
+static int      power(unsigned long value);
+static string   inverse(const string& cc);
+static void     compare(Node left, Node right);
+static void     setcc(Node expr, const string& cc);
+static void     materialize(Node expr);
+static void     spill_live();
+static void     magic(unsigned long divisor, unsigned bits, unsigned long& multiplier, unsigned& shift);
+static void     vacate(Register* reg);
+static bool     promotable(const Symbol* symbol);
+static Register* home(Node expr);
+static void     take_home(Symbol* symbol, Register* reg);
+static void     touch(Register* reg);
+static Register* where(Node expr);
+static void     fetch(Location& loc);
+static void     discard(Location& loc);
+static Register* reuse(Location& loc);
+static bool     local(Node object);
+static void     settle(Location& loc, Node owner);
+
+static void     operand(ostream& ostr, Node expr);
+static void     test(Node expr, const Label& label, bool ifTrue);
+static void     test_or(Node expr, const Label& label, bool onTrue);
+static void     test_and(Node expr, const Label& label, bool onTrue);
+static string   condition(Node expr);
+static void     generate_address(Node expr, Location& loc);
+static void     generate_location(Node expr, Location& loc);
+static void     generate_offset(Node add, Location& loc);
+static bool     generate_tail(Node expr);
+static bool     jumps(Node stmt);
+static void     shuffle(Node expr);
+static void     generate_function(Node function);
+static void     generate_call(Node expr);
+static void     generate_return(Node stmt);
+static void     generate_while(Node stmt);
+static void     generate_if(Node stmt);
+static void     generate_assignment(Node stmt);
+static void     generate_subtract(Node expr);
+static void     generate_add(Node expr);
+static void     generate_remainder(Node expr);
+static void     generate_divide(Node expr);
+static void     generate_multiply(Node expr);
+static void     generate_cast(Node cast);
+static void     generate_address_of(Node address);
+static void     generate_dereference(Node deref);
+static void     generate_negate(Node negate);
+static void     generate_field(Node field);
 
 
 /*
@@ -98,857 +234,2505 @@ static void     load(Expression* expr, Register* reg);
  *		register, and if not then uses its offset.
  */
 
-static ostream& operator << (ostream& ostr, Expression* expr)
+static ostream& operator << (ostream& ostr, Node expr)
 {
-    if (expr->_register != nullptr)
+    if (expr.reg() != nullptr)
     {
-        unsigned size = expr->type().size();
-        ostr << expr->_register->name(size);
+        unsigned size = expr.type().size();
+        ostr << expr.reg()->name(size);
     }
     else
-        expr->operand(ostr);
+        operand(ostr, expr);
 
     return ostr;
 }
 
 
 /*
- * Function:	generate_globals
+ * Function:	operator << (private)
  *
- * Description:	Generate code for any global variable declarations.
+ * Description:	Write a location as a memory operand to the specified
+ *		stream.  Its base and index must already be in registers.
  */
 
-void generate_globals(Scope* scope)
+static ostream& operator << (ostream& ostr, const Location& loc)
 {
-    const Symbols& symbols = scope->symbols();
+    Symbol* symbol;
 
-    for (unsigned i = 0; i < strings.size(); ++ i)
-        cout << strings[i] << endl;
+    if (loc.object && local(loc.object))
+    {
+        loc.object.isIdentifier(symbol);
+        ostr << symbol->_offset + loc.disp << "(%rbp";
+    }
 
-    for (unsigned i = 0; i < symbols.size(); ++ i)
-        if (!symbols[i]->type().isFunction()) 
-        {
-            cout << "\t.comm\t" << global_prefix << symbols[i]->name() << ", ";
-            cout << symbols[i]->type().size() << endl;
-        }
+    else if (loc.object)
+    {
+        if (loc.disp != 0)
+            ostr << loc.disp << "+";
+
+        operand(ostr, loc.object);
+        return ostr;
+    }
+
+    else
+    {
+        if (loc.disp != 0)
+            ostr << loc.disp;
+
+        ostr << "(" << where(loc.base)->as_qword();
+    }
+
+    if (loc.index)
+        ostr << "," << where(loc.index)->as_qword() << "," << loc.scale;
+
+    return ostr << ")";
 }
 
 
 /*
- * Function:	Expression::operand
+ * Function:	release_registers (private)
  *
- * Description:	Write an expression as an operand to the specified stream.
+ * Description:	Mark every register as free without spilling anything.
  */
 
-void Expression::operand(ostream& ostr) const
+static void release_registers()
 {
-    ostr << _offset << "(%rbp)";
+    for (unsigned i = 0; i < caller_saved.size(); ++ i)
+        caller_saved[i]->_node = Node();
+
+    for (unsigned i = 0; i < callee_saved.size(); ++ i)
+        callee_saved[i]->_node = Node();
 }
 
 
 /*
- * Function:	Identifier::operand
+ * Function:	reset_generator
  *
- * Description:	Write an identifier as an operand to the specified stream.
+ * Description:	Discard anything left over from the previous program,
+ *		including one that was abandoned part way through, so that
+ *		the code for each program is the same no matter what was
+ *		compiled before it.
  */
 
-void Identifier::operand(ostream& ostr) const
+void reset_generator()
 {
-    if (_symbol->_offset == 0)
-	    ostr << global_prefix << _symbol->name() << global_suffix;
-
-    else
-	    ostr << _symbol->_offset << "(%rbp)";
+    strings.clear();
+    spill_slots.clear();
+    Label::reset();
+    release_registers();
 }
 
 
 /*
- * Function:	Number::operand
+ * Function:	generate_globals
  *
- * Description:	Write a number as an operand to the specified stream.
+ * Description:	Generate code for any global variable declarations.
  */
 
-void Number::operand(ostream& ostr) const
+void generate_globals(Scope* scope)
 {
-    ostr << "$" << _value;
+    const Symbols& symbols = scope->symbols();
+
+    for (unsigned i = 0; i < symbols.size(); ++ i)
+        if (!symbols[i]->type().isFunction()) 
+        {
+            *output << "\t.comm\t" << global_prefix << symbols[i]->name() << ", ";
+            *output << symbols[i]->type().size() << endl;
+        }
 }
 
 
 /*
- * Function:    String::operand
- * 
- * Description: Write a string as an operand to the stream, and remember this string for later when
- *              the full assembly code is generated.
+ * Function:	operand (private)
+ *
+ * Description:	Write an expression as an operand to the specified stream.
+ *		A variable is written as its register or its memory
+ *		location, and a number as an immediate.  A string is
+ *		written as its label, and is remembered so that it can be
+ *		written out along with the rest of the function.  Any
+ *		other expression has been spilled, and is written as its
+ *		spill slot.
  */
 
-void String::operand(ostream& ostr) const
+static void operand(ostream& ostr, Node expr)
 {
-    Label label;
+    switch (expr.kind())
+    {
+        case Node::IDENTIFIER:
+        {
+            Symbol* symbol = expr.symbol();
 
-    ostr << label << global_suffix;
+            if (symbol->_register != nullptr)
+            {
+                touch(symbol->_register);
+                ostr << symbol->_register->name(expr.type().size());
+            }
 
+            else if (symbol->_offset == 0)
+	            ostr << global_prefix << symbol->name() << global_suffix;
 
-    /* Save to strings global for code generation at the end */
+            else
+	            ostr << symbol->_offset << "(%rbp)";
 
-    stringstream ss;
-    ss << label << ":\n\t.string " << _value << endl;
-    strings.push_back(ss.str());
-}
+            break;
+        }
 
+        case Node::NUMBER:
+            ostr << "$" << expr.value();
+            break;
 
-void Expression::test(const Label& label, bool ifTrue)
-{
-    generate();
+        case Node::STRING:
+        {
+            Label label;
 
-    if (_register == nullptr)
-        load(this, get_reg());
+            ostr << label << global_suffix;
 
-    cout << "\tcmp" << suffix(this) << "$0, " << this << endl;
-    cout << (ifTrue ? "\tjne\t" : "\tje\t") << label << endl;
 
-    assign(this, nullptr);
+            /* Save to strings global for code generation at the end of the function */
+
+            stringstream ss;
+            ss << label << ":\n\t.string " << expr.text() << endl;
+            strings.push_back(ss.str());
+            break;
+        }
+
+        default:
+            ostr << expr.offset() << "(%rbp)";
+            break;
+    }
 }
 
 
-void LessThan::test(const Label& label, bool onTrue)
+/*
+ * Function:	test (private)
+ *
+ * Description:	Generate code to jump to the given label if the given
+ *		expression is true, or if it is false, using the condition
+ *		code that it leaves and not a materialized boolean.
+ */
+
+static void test(Node expr, const Label& label, bool ifTrue)
 {
-    _left->generate();
-    _right->generate();
+    switch (expr.kind())
+    {
+        case Node::NOT:
+            test(expr.expr(), label, !ifTrue);
+            break;
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+        case Node::LOGICAL_OR:
+            test_or(expr, label, ifTrue);
+            break;
+
+        case Node::LOGICAL_AND:
+            test_and(expr, label, ifTrue);
+            break;
 
-    cout << "\tcmp" << suffix(_left);
-    cout << _right << ", " << _left << endl;
-    cout << (onTrue ? "\tjl\t" : "\tjge\t") << label << endl;
+        default:
+        {
+            string cc = condition(expr);
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
+            *output << "\tj" << (ifTrue ? cc : inverse(cc)) << "\t" << label << endl;
+            break;
+        }
+    }
 }
 
 
-void GreaterThan::test(const Label& label, bool onTrue)
+/*
+ * Function:	condition (private)
+ *
+ * Description:	Set the flags and return the condition code under which
+ *		the given expression is true.  A comparison sets them
+ *		itself, a logical negation is its operand the other way,
+ *		and any other value is compared with zero.
+ */
+
+static string condition(Node expr)
 {
-    _left->generate();
-    _right->generate();
+    switch (expr.kind())
+    {
+        case Node::LESS_THAN:
+            compare(expr.left(), expr.right());
+            return "l";
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+        case Node::GREATER_THAN:
+            compare(expr.left(), expr.right());
+            return "g";
 
-    cout << "\tcmp" << suffix(_left);
-    cout << _right << ", " << _left << endl;
-    cout << (onTrue ? "\tjg\t" : "\tjle\t") << label << endl;
+        case Node::LESS_OR_EQUAL:
+            compare(expr.left(), expr.right());
+            return "le";
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
-}
+        case Node::GREATER_OR_EQUAL:
+            compare(expr.left(), expr.right());
+            return "ge";
 
+        case Node::EQUAL:
+            compare(expr.left(), expr.right());
+            return "e";
 
-void LessOrEqual::test(const Label& label, bool onTrue)
-{
-    _left->generate();
-    _right->generate();
+        case Node::NOT_EQUAL:
+            compare(expr.left(), expr.right());
+            return "ne";
+
+        case Node::NOT:
+            return inverse(condition(expr.expr()));
+
+        default:
+            break;
+    }
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+    expr.generate();
 
-    cout << "\tcmp" << suffix(_left);
-    cout << _right << ", " << _left << endl;
-    cout << (onTrue ? "\tjle\t" : "\tjg\t") << label << endl;
+    if (expr.reg() == nullptr && home(expr) == nullptr)
+        load(expr, get_reg());
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
+    *output << "\tcmp" << suffix(expr) << "$0, " << expr << endl;
+
+    assign(expr, nullptr);
+    return "ne";
 }
 
 
-void GreaterOrEqual::test(const Label& label, bool onTrue)
-{
-    _left->generate();
-    _right->generate();
+/*
+ * Function:	test_or (private)
+ *
+ * Description:	Generate code to jump to the given label if either operand
+ *		is true, or if both are false, short-circuiting the right
+ *		operand.
+ */
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+static void test_or(Node expr, const Label& label, bool onTrue)
+{*output << "# === or\n";
+    if (onTrue)
+    {
+        test(expr.left(), label, true);
+        test(expr.right(), label, true);
+    }
+    else
+    {
+        Label skip;
 
-    cout << "\tcmp" << suffix(_left);
-    cout << _right << ", " << _left << endl;
-    cout << (onTrue ? "\tjge\t" : "\tjl\t") << label << endl;
+        test(expr.left(), skip, true);
+        test(expr.right(), label, false);
+
+        *output << skip << ":" << endl;
+    }
+*output << "# --- or\n";}
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
-}
 
+/*
+ * Function:	test_and (private)
+ *
+ * Description:	Generate code to jump to the given label if both operands
+ *		are true, or if either is false, short-circuiting the right
+ *		operand.
+ */
 
-void Equal::test(const Label& label, bool onTrue)
-{cout << "# ~~~ eql\n";
-    _left->generate();
-    _right->generate();
+static void test_and(Node expr, const Label& label, bool onTrue)
+{*output << "# === and\n";
+    if (onTrue)
+    {
+        Label skip;
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+        test(expr.left(), skip, false);
+        test(expr.right(), label, true);
 
-    cout << "\tcmp" << suffix(_left);
-    cout << _right << ", " << _left << endl;
-    cout << (onTrue ? "\tje\t" : "\tjne\t") << label << endl;
+        *output << skip << ":" << endl;
+    }
+    else
+    {
+        test(expr.left(), label, false);
+        test(expr.right(), label, false);
+    }
+*output << "# --- and\n";}
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
-cout << "# ~~~ eql\n";}
 
+/*
+ * Function:	Node::generate
+ *
+ * Description:	Generate code for this node.  A comparison or a logical
+ *		negation turns the flags into a value, and a logical
+ *		operator must branch to compute its value.  A block is
+ *		just its statements, and a simple (expression) statement is
+ *		just its expression.  Nothing needs to be done for a
+ *		variable, number, or string, which is used where it is.
+ */
 
-void NotEqual::test(const Label& label, bool onTrue)
+void Node::generate() const
 {
-    _left->generate();
-    _right->generate();
+    switch (kind())
+    {
+        case CALL:
+            generate_call(*this);
+            break;
+
+        case FIELD:
+            generate_field(*this);
+            break;
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+        case NOT:
+        case LESS_THAN:
+        case GREATER_THAN:
+        case LESS_OR_EQUAL:
+        case GREATER_OR_EQUAL:
+        case EQUAL:
+        case NOT_EQUAL:
+            setcc(*this, condition(*this));
+            break;
 
-    cout << "\tcmp" << suffix(_left);
-    cout << _right << ", " << _left << endl;
-    cout << (onTrue ? "\tjne\t" : "\tje\t") << label << endl;
+        case NEGATE:
+            generate_negate(*this);
+            break;
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
-}
+        case DEREFERENCE:
+            generate_dereference(*this);
+            break;
+
+        case ADDRESS:
+            generate_address_of(*this);
+            break;
+
+        case CAST:
+            generate_cast(*this);
+            break;
+
+        case MULTIPLY:
+            generate_multiply(*this);
+            break;
+
+        case DIVIDE:
+            generate_divide(*this);
+            break;
+
+        case REMAINDER:
+            generate_remainder(*this);
+            break;
+
+        case ADD:
+            generate_add(*this);
+            break;
+
+        case SUBTRACT:
+            generate_subtract(*this);
+            break;
+
+        case LOGICAL_AND:
+        case LOGICAL_OR:
+            materialize(*this);
+            break;
+
+        case ASSIGNMENT:
+            generate_assignment(*this);
+            break;
+
+        case RETURN:
+            generate_return(*this);
+            break;
+
+        case BLOCK:
+            for (unsigned i = 0; i < count(); i ++)
+	            child(i).generate();
+
+            break;
 
+        case WHILE:
+            generate_while(*this);
+            break;
+
+        case IF:
+            generate_if(*this);
+            break;
 
-void LogicalOr::test(const Label& label, bool onTrue)
-{cout << "# === or\n";
-    Label skip;
+        case SIMPLE:
+            expr().generate();
 
-    _left->test(skip, true);
-    _right->test(label, false);
+            assign(expr(), nullptr);
+            break;
 
-    cout << skip << ":" << endl;
-    cout << "\tmovl\t$1, %eax" << endl;
-cout << "# --- or\n";}
+        case FUNCTION:
+            generate_function(*this);
+            break;
 
+        default:
+            break;
+    }
+}
 
-void LogicalAnd::test(const Label& label, bool onTrue)
-{cout << "# === and\n";
-    _left->test(label, false);
-    _right->test(label, false);
-cout << "# --- and\n";}
 
 /*
- * Function:	Simple::generate
+ * Function:	generate_address (private)
  *
- * Description:	Generate code for a simple (expression) statement, which
- *		means simply generating code for the expression.
+ * Description:	Generate code for a pointer and use its value as the base
+ *		of the location to which it points.  The addition of an
+ *		offset to a pointer, and the address of an lvalue, are
+ *		folded into the location instead.
  */
 
-void Simple::generate()
+static void generate_address(Node expr, Location& loc)
 {
-    _expr->generate();
-
-    assign(_expr, nullptr);
-}
+    switch (expr.kind())
+    {
+        case Node::ADD:
+            generate_offset(expr, loc);
+            break;
 
+        case Node::ADDRESS:
+            generate_location(expr.expr(), loc);
+            break;
 
-void Expression::generate_indirect(bool& indirect)
-{
-    indirect = false;
+        default:
+            expr.generate();
 
-    generate();
+            loc.base = expr;
+            break;
+    }
 }
 
 
 /*
- * Function:	Block::generate
+ * Function:	generate_location (private)
  *
- * Description:	Generate code for this block, which simply means we
- *		generate code for each statement within the block.
+ * Description:	Generate code for an lvalue and build the memory operand
+ *		that holds it.  A variable in memory is its own location, a
+ *		dereference is the location to which its pointer points,
+ *		and a field is the location of its structure with the
+ *		offset of the field folded into the displacement.  Any
+ *		other lvalue, such as a string, can only be written as its
+ *		own operand.
  */
 
-void Block::generate()
+static void generate_location(Node expr, Location& loc)
 {
-    for (unsigned i = 0; i < _stmts.size(); i ++)
-	    _stmts[i]->generate();
+    switch (expr.kind())
+    {
+        case Node::IDENTIFIER:
+            loc.object = expr;
+            break;
+
+        case Node::DEREFERENCE:
+            generate_address(expr.expr(), loc);
+            break;
+
+        case Node::FIELD:
+            generate_location(expr.expr(), loc);
+
+            loc.disp += expr.symbol()->_offset;
+            break;
+
+        default:
+            expr.generate();
+
+            loc.object = expr;
+            break;
+    }
 }
 
 
 /*
- * Function:	Call::generate
+ * Function:	generate_call (private)
  *
  * Description:	Generate code for a function call expression.
  */
 
-void Call::generate()
-{cout << "# === call\n";
+static void generate_call(Node expr)
+{*output << "# === call\n";
     unsigned long value, size, bytesPushed = 0;
+    unsigned count = expr.count();
 
 
     /* Generate any arguments with function calls first. */
 
-    for (int i = _args.size() - 1; i >= 0; -- i)
-	    if (_args[i]->_hasCall)
-	        _args[i]->generate();
+    for (int i = count - 1; i >= 0; -- i)
+	    if (expr.child(i).hasCall())
+	        expr.child(i).generate();
 
 
     /* Adjust the stack if necessary. */
 
-    if (_args.size() > NUM_PARAM_REGS) 
+    if (count > NUM_PARAM_REGS)
     {
-        bytesPushed = align((_args.size() - NUM_PARAM_REGS) * SIZEOF_PARAM);
+        bytesPushed = align((count - NUM_PARAM_REGS) * SIZEOF_PARAM);
 
         if (bytesPushed > 0)
-            cout << "\tsubq\t$" << bytesPushed << ", %rsp" << endl;
+            *output << "\tsubq\t$" << bytesPushed << ", %rsp" << endl;
     }
 
 
     /* Move the arguments into the correct registers or memory locations. */
 
-    for (int i = _args.size() - 1; i >= 0; -- i) 
+    for (int i = count - 1; i >= 0; -- i)
     {
-        size = _args[i]->type().size();
+        Node arg = expr.child(i);
+
+        size = arg.type().size();
 
-        if (!_args[i]->_hasCall)
-            _args[i]->generate();
+        if (!arg.hasCall())
+            arg.generate();
 
         if (i < NUM_PARAM_REGS)
-            load(_args[i], parameters[i]);
+            load(arg, parameters[i]);
 
         else
         {
             bytesPushed += SIZEOF_PARAM;
 
-            if (_args[i]->_register)
-                cout << "\tpushq\t" << _args[i]->_register->name() << endl;
+            if (arg.reg())
+                *output << "\tpushq\t" << arg.reg()->name() << endl;
 
-            else if (_args[i]->isNumber(value) || size == SIZEOF_PARAM)
-                cout << "\tpushq\t" << _args[i] << endl;
-            
-            else 
+            else if (arg.isNumber(value) || size == SIZEOF_PARAM)
+                *output << "\tpushq\t" << arg << endl;
+
+            else
             {
-                load(_args[i], rax);
+                load(arg, rax);
 
-                cout << "\tpushq\t%rax" << endl;
+                *output << "\tpushq\t%rax" << endl;
             }
-        }
 
-        assign(_args[i], nullptr);
+            assign(arg, nullptr);
+        }
     }
 
 
-    /* Spill any caller-saved registers still in use. */
+    /* An argument already in its register may have been spilled to make
+       room for computing another, so make sure each is back in place
+       before any are released. */
+
+    for (unsigned i = 0; i < count && i < NUM_PARAM_REGS; ++ i)
+        load(expr.child(i), parameters[i]);
+
+    for (unsigned i = 0; i < count && i < NUM_PARAM_REGS; ++ i)
+        assign(expr.child(i), nullptr);
+
+
+    /* Every value still in a caller-saved register is used after the
+       call, since each is released as soon as it is used.  Move any that
+       must be kept into free callee-saved registers, which survive the
+       call, and spill the rest. */
 
     for (unsigned i = 0; i < caller_saved.size(); ++ i)
-	    load(nullptr, caller_saved[i]);
+        if (caller_saved[i]->_node)
+        {
+            Register* reg = nullptr;
+
+            if (recomputable(caller_saved[i]->_node))
+            {
+                load(Node(), caller_saved[i]);
+                continue;
+            }
+
+            for (unsigned j = 0; j < callee_saved.size() && reg == nullptr; ++ j)
+                if (!callee_saved[j]->_node)
+                    if (find(variables.begin(), variables.end(), callee_saved[j]) == variables.end())
+                        reg = callee_saved[j];
+
+            if (reg != nullptr)
+            {
+                unsigned defined = caller_saved[i]->_defined;
+
+                *output << "\tmovq\t" << caller_saved[i]->as_qword() << ", " << reg->as_qword() << endl;
+
+                touch(reg);
+                assign(caller_saved[i]->_node, reg);
+                reg->_defined = defined;
+            }
+            else
+                load(Node(), caller_saved[i]);
+        }
 
 
     /* Call the function.  Technically, we only need to assign the number
        of floating point arguments to %eax if the function being called
        takes a variable number of arguments.  But, it never hurts. */
 
-    if (_id->type().parameters() == nullptr)
-	    cout << "\tmovl\t$0, %eax" << endl;
+    if (expr.symbol()->type().parameters() == nullptr)
+	    *output << "\tmovl\t$0, %eax" << endl;
 
-    cout << "\tcall\t" << global_prefix << _id->name() << endl;
+    *output << "\tcall\t" << global_prefix << expr.symbol()->name() << endl;
 
 
     /* Reclaim the space of any arguments pushed on the stack. */
 
     if (bytesPushed > 0)
-	    cout << "\taddq\t$" << bytesPushed << ", %rsp" << endl;
+	    *output << "\taddq\t$" << bytesPushed << ", %rsp" << endl;
 
-    assign(this, rax);
-cout << "# --- call\n";}
+    assign(expr, rax);
+*output << "# --- call\n";}
 
 
 /*
- * Function:	Function::generate
- *
- * Description:	Generate code for this function, which entails allocating
- *		space for local variables, then emitting our prologue, the
- *		body of the function, and the epilogue.
- *
- *		The stack must be aligned at the point at which a function
- *		begins execution.  Since the call instruction pushes the
- *		return address on the stack and each function is expected
- *		to push its base pointer, we adjust our offset by that
- *		amount and then perform the alignment.
- *
- *		On a 32-bit Intel platform, 8 bytes are pushed (4 for the
- *		return address and 4 for the base pointer).  Since Linux
- *		requires a 4-byte alignment, all we need to do is ensure
- *		the stack size is a multiple of 4, which will usually
- *		already be the case.  However, since OS X requires a
- *		16-byte alignment (thanks, Apple, for inventing your own
- *		standards), we will often see an extra amount of stack
- *		space allocated.
+ * Function:	jumps (private)
  *
- *		On a 64-bit Intel platform, 16 bytes are pushed (8 for the
- *		return address and 8 for the base pointer).  Both Linux and
- *		OS X require 16-byte alignment.
+ * Description:	Return whether every call in the given statement is one
+ *		that generate_tail() makes.  Nothing is live after such a
+ *		call, since it is a jump or is followed only by our
+ *		epilogue, so a function whose body this is may keep its
+ *		variables in the caller-saved registers, like a function
+ *		that makes no calls at all.
  */
 
-void Function::generate()
+static bool jumps(Node stmt)
 {
-    unsigned        size;
-    int             param_offset;
-    Parameters*     params          = _id->type().parameters();
-    const Symbols&  symbols         = _body->declarations()->symbols();
-
-    return_label = new Label();
+    Node expr;
 
+    switch (stmt.kind())
+    {
+        case Node::RETURN:
+            expr = stmt.expr();
 
-    /* Assign offsets to all symbols within the scope of the function. */
+            if (!expr.hasCall())
+                return true;
 
-    param_offset = PARAM_OFFSET + SIZEOF_REG * callee_saved.size();
-    offset = param_offset;
-    allocate(offset);
+            if (expr.kind() != Node::CALL || expr.count() > NUM_PARAM_REGS)
+                return false;
 
+            for (unsigned i = 0; i < expr.count(); ++ i)
+                if (expr.child(i).hasCall())
+                    return false;
 
-    /* Generate the prologue. */
+            return true;
 
-    func_name = _id->name();
+        case Node::BLOCK:
+            for (unsigned i = 0; i < stmt.count(); ++ i)
+                if (!jumps(stmt.child(i)))
+                    return false;
 
-    cout << global_prefix << func_name << ":" << endl;
-    cout << "\tpushq\t%rbp" << endl;
+            return true;
 
-    for (unsigned i = 0; i < callee_saved.size(); ++ i)
-	    cout << "\tpushq\t" << callee_saved[i] << endl;
+        case Node::WHILE:
+            return !stmt.expr().hasCall() && jumps(stmt.stmt());
 
-    cout << "\tmovq\t%rsp, %rbp" << endl;
+        case Node::IF:
+            if (stmt.expr().hasCall() || !jumps(stmt.thenStmt()))
+                return false;
 
-    if (SIMPLE_PROLOGUE) 
-    {
-	    offset -= align(offset - param_offset);
+            return !stmt.elseStmt() || jumps(stmt.elseStmt());
 
-	    cout << "\tsubq\t$" << -offset << ", %rsp" << endl;
-    }
-    else 
-    {
-	    cout << "\tmovl\t$" << func_name << ".size, %eax" << endl;
-	    cout << "\tsubq\t%rax, %rsp" << endl;
+        default:
+            return !stmt.hasCall();
     }
+}
 
 
-    /* Spill any parameters. */
+/*
+ * Function:	shuffle (private)
+ *
+ * Description:	Move the arguments of a tail call into the parameter
+ *		registers when some of those registers hold variables.
+ *		Every argument is computed before any of the registers is
+ *		written, and the values already in registers are then
+ *		moved all at once, exchanging two registers to break a
+ *		cycle, so that no variable is overwritten before it is
+ *		read.  Numbers and values in memory are loaded last.
+ */
 
-    for (unsigned i = 0; i < NUM_PARAM_REGS; ++ i)
-        if (i < params->size()) 
-        {
-            size = symbols[i]->type().size();
+static void shuffle(Node expr)
+{
+    unsigned count = expr.count(), size, j;
+    Registers source(count);
+    bool moved = true;
 
-            cout << "\tmov" << suffix(size) << parameters[i]->name(size);
-            cout << ", " << symbols[i]->_offset << "(%rbp)" << endl;
-        } 
-        else
-            break;
+    for (int i = count - 1; i >= 0; -- i)
+        if (expr.child(i).hasCall())
+            expr.child(i).generate();
 
+    for (int i = count - 1; i >= 0; -- i)
+        if (!expr.child(i).hasCall())
+            expr.child(i).generate();
 
-    /* Generate the body and epilogue. */
 
-    registers = (_hasCall && callee_saved.size() ? callee_saved : caller_saved);
+    /* Take each argument in a register out of it, since the moves below
+       are made behind the back of load(), and spill anything else in
+       the way. */
 
-    _body->generate();
+    for (unsigned i = 0; i < count; ++ i)
+    {
+        Node arg = expr.child(i);
 
-    cout << *return_label << ":" << endl;
-    cout << endl << global_prefix << func_name << ".exit:" << endl;
-    cout << "\tmovq\t%rbp, %rsp" << endl;
+        source[i] = (arg.reg() != nullptr ? arg.reg() : home(arg));
 
-    for (int i = callee_saved.size() - 1; i >= 0; -- i)
-	    cout << "\tpopq\t" << callee_saved[i] << endl;
+        if (arg.reg() != nullptr)
+        {
+            arg.reg()->_node = Node();
+            arg.reg() = nullptr;
+        }
+    }
 
-    cout << "\tpopq\t%rbp" << endl;
-    cout << "\tret" << endl << endl;
+    for (unsigned i = 0; i < count; ++ i)
+        if (parameters[i]->_node)
+            load(Node(), parameters[i]);
 
 
-    /* Finish aligning the stack. */
+    /* Move a value into its register once no other value still to be
+       moved is in that register. */
 
-    if (!SIMPLE_PROLOGUE) 
+    while (moved)
     {
-	    offset -= align(offset - param_offset);
+        moved = false;
 
-	    cout << "\t.set\t" << func_name << ".size, " << -offset << endl;
-    }
+        for (unsigned i = 0; i < count; ++ i)
+            if (source[i] != nullptr && source[i] != parameters[i])
+            {
+                for (j = 0; j < count; ++ j)
+                    if (j != i && source[j] == parameters[i])
+                        break;
 
-    cout << "\t.globl\t" << global_prefix << func_name << endl;
-    cout << "\t.type\t" << global_prefix << func_name << ", @function" << endl << endl;
-}
+                if (j == count)
+                {
+                    size = expr.child(i).type().size();
 
+                    touch(source[i]);
+                    *output << "\tmov" << suffix(size) << source[i]->name(size) << ", ";
+                    *output << parameters[i]->name(size) << endl;
 
-void Return::generate()
-{cout << "# === retn\n";
-    _expr->generate();
+                    source[i] = parameters[i];
+                    moved = true;
+                }
+            }
+
+        for (unsigned i = 0; i < count && !moved; ++ i)
+            if (source[i] != nullptr && source[i] != parameters[i])
+            {
+                touch(source[i]);
+                *output << "\txchgq\t" << source[i]->as_qword() << ", " << parameters[i]->as_qword() << endl;
+
+                for (j = 0; j < count; ++ j)
+                    if (source[j] == parameters[i])
+                        source[j] = source[i];
+
+                source[i] = parameters[i];
+                moved = true;
+            }
+    }
+
+    for (unsigned i = 0; i < count; ++ i)
+        if (source[i] == nullptr)
+            load(expr.child(i), parameters[i]);
+}
+
+
+/*
+ * Function:	generate_tail (private)
+ *
+ * Description:	Generate code for a call whose result is returned as is,
+ *		and return whether the expression is such a call.  The
+ *		arguments are put in place as for any other call, and then
+ *		we jump to a stub that either leaves the frame and jumps to
+ *		the callee, or goes back to the start of the body if the
+ *		callee is this function.  A call with arguments on the
+ *		stack would have to overwrite our own incoming ones, so it
+ *		is left to generate_call().  If a parameter register holds
+ *		a variable, as it may in a function that makes no other
+ *		calls, the arguments are moved by shuffle() instead.
+ */
+
+static bool generate_tail(Node expr)
+{
+    unsigned count = expr.count();
+    bool clobber = false;
+
+    if (expr.kind() != Node::CALL || count > NUM_PARAM_REGS)
+        return false;
+
+*output << "# === tail\n";
+    for (unsigned i = 0; i < count && !clobber; ++ i)
+        if (find(variables.begin(), variables.end(), parameters[i]) != variables.end())
+            clobber = true;
+
+    if (clobber)
+        shuffle(expr);
+    else
+    {
+        for (int i = count - 1; i >= 0; -- i)
+	        if (expr.child(i).hasCall())
+	            expr.child(i).generate();
+
+        for (int i = count - 1; i >= 0; -- i)
+        {
+            if (!expr.child(i).hasCall())
+                expr.child(i).generate();
+
+            load(expr.child(i), parameters[i]);
+        }
+
+        for (unsigned i = 0; i < count; ++ i)
+            load(expr.child(i), parameters[i]);
+    }
+
+    for (unsigned i = 0; i < count; ++ i)
+        assign(expr.child(i), nullptr);
+
+    if (expr.symbol()->type().parameters() == nullptr)
+	    *output << "\tmovl\t$0, %eax" << endl;
+
+    tails.push_back(Tail());
+    tails.back().callee = expr.symbol();
+    tails.back().exit = return_label;
+
+    *output << "\tjmp\t" << tails.back().label << endl;
+*output << "# --- tail\n";
+    return true;
+}
+
+
+/*
+ * Function:	generate_function (private)
+ *
+ * Description:	Generate code for a function, which entails allocating
+ *		space for local variables, then emitting our prologue, the
+ *		body of the function, and the epilogue.
+ *
+ *		The stack must be aligned at the point at which a function
+ *		begins execution.  Since the call instruction pushes the
+ *		return address on the stack and each function is expected
+ *		to push its base pointer, we adjust our offset by that
+ *		amount and then perform the alignment.
+ *
+ *		On a 32-bit Intel platform, 8 bytes are pushed (4 for the
+ *		return address and 4 for the base pointer).  Since Linux
+ *		requires a 4-byte alignment, all we need to do is ensure
+ *		the stack size is a multiple of 4, which will usually
+ *		already be the case.  However, since OS X requires a
+ *		16-byte alignment (thanks, Apple, for inventing your own
+ *		standards), we will often see an extra amount of stack
+ *		space allocated.
+ *
+ *		On a 64-bit Intel platform, 16 bytes are pushed (8 for the
+ *		return address and 8 for the base pointer).  Both Linux and
+ *		OS X require 16-byte alignment.
+ *
+ *		A parameter that may be kept in a register stays in the
+ *		one it was passed in if it can.  The callee-saved registers
+ *		are saved in the frame only if the function uses them, and
+ *		only on the paths that need them.
+ */
+
+static void generate_function(Node function)
+{
+    unsigned           size, first;
+    int                param_offset;
+    const Symbol*      id              = function.symbol();
+    const Parameters*  params          = id->type().parameters();
+    const Symbols&     symbols         = function.body().declarations()->symbols();
+    Node               body            = function.body();
+    ostream*           out             = output;
+    vector<Symbol*>    deferred;
+    Registers          destined, saved;
+    vector<int>        slots;
+    vector<string>     code;
+    vector<Label>      exits(body.count());
+    stringstream       entry;
+
+    position = 0;
+    spill_slots.clear();
+    touched.clear();
+    tails.clear();
+    escaped = false;
+    cold.clear();
+
+
+    /* Decide which registers may hold variables.  A parameter that can
+       stay where it was passed does so, and the others compete with the
+       variables for the rest.  A function whose only calls are jumps
+       counts as making no calls. */
+
+    homes = (jumps(body) ? leaf_homes : Registers());
+    variables.clear();
+
+    homes.insert(homes.end(), callee_saved.begin(), callee_saved.end());
+
+    for (unsigned i = 0; i < params->size() && i < NUM_PARAM_REGS; ++ i)
+        if (promotable(symbols[i]))
+            if (find(homes.begin(), homes.end(), parameters[i]) != homes.end())
+                take_home(symbols[i], parameters[i]);
+
+
+    /* Assign offsets to all symbols within the scope of the function. */
+
+    param_offset = PARAM_OFFSET;
+    offset = param_offset;
+    function.allocate(offset);
+
+
+    /* Spill any parameters that are not kept in registers, and only then
+       move the others, since a register may be taken from a parameter
+       that is spilled.  A parameter headed for a callee-saved register
+       waits where it was passed until the first statement with a call,
+       so that a function that returns early need not save it. */
+
+    output = &entry;
+
+    for (unsigned i = 0; i < NUM_PARAM_REGS; ++ i)
+        if (i < params->size()) 
+        {
+            if (symbols[i]->_register == nullptr)
+            {
+                size = symbols[i]->type().size();
+
+                *output << "\tmov" << suffix(size) << parameters[i]->name(size);
+                *output << ", " << symbols[i]->_offset << "(%rbp)" << endl;
+            }
+        } 
+        else
+            break;
+
+    for (unsigned i = 0; i < params->size(); ++ i)
+        if (symbols[i]->_register != nullptr)
+        {
+            size = symbols[i]->type().size();
+
+            if (i >= NUM_PARAM_REGS)
+            {
+                *output << "\tmov" << suffix(size) << symbols[i]->_offset << "(%rbp), ";
+                *output << symbols[i]->_register->name(size) << endl;
+
+                touch(symbols[i]->_register);
+            }
+            else if (symbols[i]->_register != parameters[i])
+            {
+                if (body.count() > 0 && !body.child(0).hasCall())
+                    if (find(leaf_homes.begin(), leaf_homes.end(), parameters[i]) != leaf_homes.end())
+                        if (find(variables.begin(), variables.end(), parameters[i]) == variables.end())
+                        {
+                            deferred.push_back(symbols[i]);
+                            destined.push_back(symbols[i]->_register);
+                            symbols[i]->_register = parameters[i];
+                            variables.push_back(parameters[i]);
+                            continue;
+                        }
+
+                *output << "\tmov" << suffix(size) << parameters[i]->name(size) << ", ";
+                *output << symbols[i]->_register->name(size) << endl;
+
+                touch(symbols[i]->_register);
+            }
+        }
+
+    code.push_back(entry.str());
+    first = touched.empty() ? body.count() + 1 : 0;
+
+
+    /* Generate each statement of the body separately, keeping the
+       registers that hold variables out of the way of any temporaries.
+       The callee-saved registers are saved just before the first
+       statement to use one, and a return from any earlier statement
+       leaves without restoring them. */
+
+    for (unsigned i = 0; i < body.count(); ++ i)
+    {
+        stringstream stmt;
+
+        output = &stmt;
+
+        if (i == 0 || (!deferred.empty() && body.child(i).hasCall()))
+        {
+            for (unsigned j = 0; j < deferred.size() && body.child(i).hasCall(); ++ j)
+            {
+                size = deferred[j]->type().size();
+
+                *output << "\tmov" << suffix(size) << deferred[j]->_register->name(size) << ", ";
+                *output << destined[j]->name(size) << endl;
+
+                variables.erase(find(variables.begin(), variables.end(), deferred[j]->_register));
+                deferred[j]->_register = destined[j];
+                touch(destined[j]);
+            }
+
+            if (body.child(i).hasCall())
+                deferred.clear();
+
+            registers.clear();
+
+            for (Register* reg : caller_saved)
+                if (find(variables.begin(), variables.end(), reg) == variables.end())
+                    registers.push_back(reg);
+        }
+
+        return_label = &exits[i];
+        body.child(i).generate();
+
+        code.push_back(stmt.str());
+
+        if (first > body.count() && !touched.empty())
+            first = i + 1;
+    }
+
+    output = out;
+
+
+    /* A call to ourselves in tail position goes back to the start of the
+       body, which must therefore come after the registers are saved. */
+
+    for (unsigned i = 0; i < tails.size(); ++ i)
+        if (tails[i].callee == id && !escaped)
+            first = 0;
+
+
+    /* Give each callee-saved register that we used a slot in the frame. */
+
+    for (unsigned i = 0; i < touched.size(); ++ i)
+    {
+        offset -= SIZEOF_REG + (SIZEOF_REG - offset % SIZEOF_REG) % SIZEOF_REG;
+        saved.push_back(touched[i]);
+        slots.push_back(offset);
+    }
+
+
+    /* Generate the prologue, body, and epilogue. */
+
+    func_name = id->name().str();
+
+    *output << global_prefix << func_name << ":" << endl;
+    *output << "\tpushq\t%rbp" << endl;
+    *output << "\tmovq\t%rsp, %rbp" << endl;
+
+    if (SIMPLE_PROLOGUE) 
+    {
+	    offset -= align(offset - param_offset);
+
+	    *output << "\tsubq\t$" << -offset << ", %rsp" << endl;
+    }
+    else 
+    {
+	    *output << "\tmovl\t$" << func_name << ".size, %eax" << endl;
+	    *output << "\tsubq\t%rax, %rsp" << endl;
+    }
+
+    for (unsigned i = 0; i < code.size(); ++ i)
+    {
+        if (i == first)
+            for (unsigned j = 0; j < saved.size(); ++ j)
+                *output << "\tmovq\t" << saved[j] << ", " << slots[j] << "(%rbp)" << endl;
+
+        if (i == 0)
+            for (unsigned j = 0; j < tails.size(); ++ j)
+                if (tails[j].callee == id && !escaped)
+                    *output << tails[j].label << ":" << endl;
+
+        *output << code[i];
+    }
+
+    for (unsigned i = 0; i < body.count(); ++ i)
+        if (i + 1 >= first)
+            *output << exits[i] << ":" << endl;
+
+    *output << endl << global_prefix << func_name << ".exit:" << endl;
+
+    for (unsigned i = 0; i < saved.size(); ++ i)
+        *output << "\tmovq\t" << slots[i] << "(%rbp), " << saved[i] << endl;
+
+    for (unsigned i = 0; i < body.count(); ++ i)
+        if (i + 1 < first)
+            *output << exits[i] << ":" << endl;
+
+    *output << "\tmovq\t%rbp, %rsp" << endl;
+    *output << "\tpopq\t%rbp" << endl;
+    *output << "\tret" << endl << endl;
+
+
+    /* Write the unlikely branches, which all leave by one of our exits. */
+
+    for (unsigned i = 0; i < cold.size(); ++ i)
+        *output << cold[i];
+
+    if (!cold.empty())
+        *output << endl;
+
+
+    /* Finish each tail call to another function by leaving the frame,
+       restoring the registers only if its statement saved them, or by
+       making an ordinary call if the frame must stay. */
+
+    for (unsigned i = 0; i < tails.size(); ++ i)
+        if (escaped)
+        {
+            *output << tails[i].label << ":" << endl;
+            *output << "\tcall\t" << global_prefix << tails[i].callee->name() << endl;
+            *output << "\tjmp\t" << *tails[i].exit << endl;
+        }
+        else if (tails[i].callee != id)
+        {
+            *output << tails[i].label << ":" << endl;
+
+            if (tails[i].exit - &exits[0] + 1 >= first)
+                for (unsigned j = 0; j < saved.size(); ++ j)
+                    *output << "\tmovq\t" << slots[j] << "(%rbp), " << saved[j] << endl;
+
+            *output << "\tmovq\t%rbp, %rsp" << endl;
+            *output << "\tpopq\t%rbp" << endl;
+            *output << "\tjmp\t" << global_prefix << tails[i].callee->name() << endl;
+        }
+
+    if (!tails.empty())
+        *output << endl;
+
+
+    /* Finish aligning the stack. */
+
+    if (!SIMPLE_PROLOGUE) 
+    {
+	    offset -= align(offset - param_offset);
+
+	    *output << "\t.set\t" << func_name << ".size, " << -offset << endl;
+    }
+
+    *output << "\t.globl\t" << global_prefix << func_name << endl;
+    *output << "\t.type\t" << global_prefix << func_name << ", @function" << endl << endl;
+
+
+    /* Write out the string literals used by this function now, rather
+       than keeping them until the end of the program. */
+
+    for (unsigned i = 0; i < strings.size(); ++ i)
+        *output << strings[i] << endl;
+
+    strings.clear();
+
+
+    /* A value left in a register, such as the last one returned, is dead
+       once the function ends, and its node is about to be released. */
+
+    release_registers();
+}
+
+
+
+static void generate_return(Node stmt)
+{
+    Node expr = stmt.expr();
+
+    if (generate_tail(expr))
+        return;
+
+*output << "# === retn\n";
+    expr.generate();
+
+    *output << "\tmov" << suffix(expr) << expr << ", ";
+    *output << (expr.type().size() == SIZEOF_LONG ? rax->as_qword() : rax->as_lword()) << endl;
+    *output << "\tjmp\t" << *return_label << endl;
+
+    assign(expr, nullptr);
+*output << "# --- retn\n";}
+
+
+/*
+ * Function:	generate_while (private)
+ *
+ * Description:	Generate code for a while loop with the test at the bottom,
+ *		so that each iteration takes only the branch back to the top.
+ *		A copy of the test guards the entry to the loop, unless the
+ *		test makes a call, in which case we jump to the test instead.
+ *		The top of the loop is aligned since it is the target of the
+ *		branch taken most often.
+ */
+
+static void generate_while(Node stmt)
+{*output << "# === whil\n";
+    Node expr = stmt.expr();
+    Label loop, next, exit;
+
+    if (expr.hasCall())
+        *output << "\tjmp\t" << next << endl;
+    else
+        test(expr, exit, false);
+
+    *output << "\t.p2align\t4,,10" << endl;
+    *output << "\t.p2align\t3" << endl;
+    *output << loop << ":" << endl;
+
+    stmt.stmt().generate();
+
+    *output << next << ":" << endl;
+    test(expr, loop, true);
+    *output << exit << ":" << endl;
+*output << "# --- whil\n";}
+
+
+/*
+ * Function:	outline (private)
+ *
+ * Description:	Generate code for a statement that always returns, such
+ *		as an early exit, out of line at the given label.
+ */
+
+static void outline(const Label& label, Node stmt)
+{
+    ostream* out = output;
+    stringstream code;
+
+    output = &code;
+    *output << label << ":" << endl;
+
+    stmt.generate();
+
+    output = out;
+    cold.push_back(code.str());
+}
+
+
+/*
+ * Function:	generate_if (private)
+ *
+ * Description:	Generate code for an if statement.  A branch that always
+ *		returns while the other does not is predicted not to be
+ *		taken, and is moved out of line so that the other falls
+ *		through.  Otherwise, the then branch falls through.
+ */
+
+static void generate_if(Node stmt)
+{*output << "# === if\n";
+    Node expr = stmt.expr();
+    Node thenStmt = stmt.thenStmt();
+    Node elseStmt = stmt.elseStmt();
+    Label skip, exit;
+
+    if (thenStmt.returns() && (!elseStmt || !elseStmt.returns()))
+    {
+        test(expr, skip, true);
+        outline(skip, thenStmt);
+
+        if (elseStmt)
+            elseStmt.generate();
+    }
+    else if (elseStmt && elseStmt.returns() && !thenStmt.returns())
+    {
+        test(expr, skip, false);
+        thenStmt.generate();
+        outline(skip, elseStmt);
+    }
+    else if (elseStmt)
+    {
+        test(expr, skip, false);
+        thenStmt.generate();
+
+        *output << "\tjmp\t" << exit << endl;
+        *output << skip << ":" << endl;
+
+        elseStmt.generate();
+
+        *output << exit << ":" << endl;
+    }
+    else
+    {
+        test(expr, skip, false);
+        thenStmt.generate();
+
+        *output << skip << ":" << endl;
+    }
+
+*output << "# --- if\n";}
+
+
+/*
+ * Function:	generate_assignment (private)
+ *
+ * Description:	Generate code for an assignment statement.
+ */
+
+static void generate_assignment(Node stmt)
+{*output << "# === asgn\n";
+    Node left = stmt.left();
+    Node right = stmt.right();
+    Symbol* symbol;
+
+    if (left.isIdentifier(symbol))
+    {
+        right.generate();
+
+        if (right.reg() == nullptr && home(right) == nullptr)
+            if (home(left) == nullptr)
+                load(right, get_reg());
+
+        *output << "\tmov" << suffix(right) << right << ", " << left << endl;
+    }
+    else
+    {
+        Location loc;
+
+        generate_location(left, loc);
+        right.generate();
+
+        if (right.reg() == nullptr && home(right) == nullptr)
+            load(right, get_reg(loc.base));
+
+        fetch(loc);
+
+        *output << "\tmov" << suffix(right) << right << ", " << loc << endl;
+
+        discard(loc);
+    }
+
+    assign(right, nullptr);
+
+*output << "# --- asgn\n";}
+
+
+static void generate_subtract(Node expr)
+{
+    Node left = expr.left();
+    Node right = expr.right();
+    generate_operands(left, right);
+
+    if (left.reg() == nullptr)
+        load(left, get_reg(right));
+
+    *output << "\tsub" << suffix(left);
+    *output << right << ", " << left << endl;
+
+    assign(right, nullptr);
+    assign(expr, left.reg());
+}
+
+
+static void generate_add(Node expr)
+{
+    Node left = expr.left();
+    Node right = expr.right();
+
+    generate_operands(left, right);
+
+    if (left.reg() == nullptr && right.reg() != nullptr)
+        if (left.type().size() == right.type().size())
+            swap(left, right);
+
+    if (left.reg() == nullptr)
+        load(left, get_reg(right));
+
+    *output << "\tadd" << suffix(left);
+    *output << right << ", " << left << endl;
+
+    assign(right, nullptr);
+    assign(expr, left.reg());
+}
+
+
+static void generate_remainder(Node expr)
+{
+    Node left = expr.left();
+    Node right = expr.right();
+    unsigned long value;
+
+    generate_operands(left, right);
+
+    if (divide_constant(expr, left, right, true))
+        return;
+
+    if (right.isNumber(value))
+        load(right, get_reg(left));
+
+    if (rax->_node != left)
+        vacate(rax);
+
+    load(left, rax);
+    vacate(rdx);
+
+    *output << (left.type().size() == SIZEOF_LONG ? "\tcqto" : "\tcltd") << endl;
+    *output << "\tidiv" << suffix(right) << right << endl;
+
+    assign(right, nullptr);
+    assign(left, nullptr);
+    assign(expr, rdx);
+}
+
+
+static void generate_divide(Node expr)
+{
+    Node left = expr.left();
+    Node right = expr.right();
+    unsigned long value;
+
+    generate_operands(left, right);
+
+    if (divide_constant(expr, left, right, false))
+        return;
+
+    if (right.isNumber(value))
+        load(right, get_reg(left));
+
+    if (rax->_node != left)
+        vacate(rax);
+
+    load(left, rax);
+    vacate(rdx);
+
+    *output << (left.type().size() == SIZEOF_LONG ? "\tcqto" : "\tcltd") << endl;
+    *output << "\tidiv" << suffix(right) << right << endl;
+
+    assign(right, nullptr);
+    assign(expr, rax);
+}
+
+
+static void generate_multiply(Node expr)
+{
+    Node left = expr.left();
+    Node right = expr.right();
+
+    generate_operands(left, right);
+
+    if (multiply_constant(expr, left, right) || multiply_constant(expr, right, left))
+        return;
+
+    if (left.reg() == nullptr && right.reg() != nullptr)
+        if (left.type().size() == right.type().size())
+            swap(left, right);
+
+    if (left.reg() == nullptr)
+        load(left, get_reg(right));
+
+    *output << "\timul" << suffix(right) << right << ", " << left << endl;
+
+    assign(right, nullptr);
+    assign(expr, left.reg());
+}
+
+
+static void generate_cast(Node cast)
+{*output << "# === cast\n";
+    Node expr = cast.expr();
+
+    expr.generate();
+
+    unsigned source = expr.type().size();
+    unsigned target = cast.type().size();
+
+    if (expr.reg() == nullptr)
+        load(expr, get_reg());
+
+    if (target <= source)
+        assign(cast, expr.reg());
+    else
+    {
+        *output << "\tmovslq\t" << expr << ", " << expr.reg()->as_qword() << endl;
+
+        assign(cast, expr.reg());
+        assign(expr, nullptr);
+    }
+*output << "# --- cast\n";}
+
+
+/*
+ * Function:	generate_offset (private)
+ *
+ * Description:	Fold the addition of an offset to a pointer into the
+ *		location to which the pointer points.  A constant offset
+ *		becomes part of the displacement, and an offset that is
+ *		scaled by the size of an element becomes the index.  A
+ *		location can have only one index and a global cannot be
+ *		indexed at all, so such a location is first computed into
+ *		a register, but for a global only once the index is ready.
+ */
+
+static void generate_offset(Node add, Location& loc)
+{
+    Node left = add.left();
+    Node right = add.right();
+    Node index = right;
+    unsigned long scale = 1, value;
+    bool first;
+
+    if (right.isNumber(value))
+    {
+        generate_address(left, loc);
+
+        long disp = loc.disp + (long) value;
+
+        if (disp >= INT_MIN && disp <= INT_MAX)
+        {
+            loc.disp = disp;
+            return;
+        }
+
+        if (loc.index)
+            settle(loc, left);
+    }
+    else
+    {
+        if (right.isScaled(index, scale))
+            if (scale != 1 && scale != 2 && scale != 4 && scale != 8)
+            {
+                index = right;
+                scale = 1;
+            }
+
+        first = !left.hasCall() && !index.hasCall() && index.need() > left.need();
+
+        if (first)
+            index.generate();
+
+        generate_address(left, loc);
+
+        if (loc.index)
+            settle(loc, left);
+
+        if (!first)
+            index.generate();
+    }
+
+    if (loc.object && !local(loc.object))
+        settle(loc, left);
+
+    loc.index = index;
+    loc.scale = scale;
+}
+
+
+/*
+ * Function:	generate_address_of (private)
+ *
+ * Description:	Generate code for taking the address of an lvalue.  If the
+ *		lvalue is found through a pointer in a temporary, then that
+ *		pointer is already the address.
+ */
+
+static void generate_address_of(Node address)
+{*output << "# === addr\n";
+    Location loc;
+
+    generate_location(address.expr(), loc);
+
+    if (!loc.object && !loc.index && loc.disp == 0 && loc.base.reg() != nullptr)
+        assign(address, loc.base.reg());
+    else
+    {
+        fetch(loc);
+
+        Register* reg = reuse(loc);
+
+        *output << "\tleaq\t" << loc << ", " << reg->as_qword() << endl;
+
+        if (loc.object && local(loc.object))
+            escaped = true;
+
+        discard(loc);
+        assign(address, reg);
+    }
+*output << "# --- addr\n";}
+
+
+/*
+ * Function:	generate_dereference (private)
+ *
+ * Description:	Generate code to load the value to which a pointer points,
+ *		using a single memory operand for the pointer arithmetic.
+ */
+
+static void generate_dereference(Node deref)
+{*output << "# === deref\n";
+    Location loc;
+
+    generate_address(deref.expr(), loc);
+    fetch(loc);
+
+    Register* reg = reuse(loc);
+
+    *output << "\tmov" << suffix(deref) << loc << ", " << reg->name(deref.type().size()) << endl;
+
+    discard(loc);
+    assign(deref, reg);
+*output << "# --- deref\n";}
+
+
+static void generate_negate(Node negate)
+{
+    Node expr = negate.expr();
+
+    expr.generate();
+
+    if (expr.reg() == nullptr)
+        load(expr, get_reg());
+
+    *output << "\tneg" << suffix(expr) << expr << endl;
+
+    assign(negate, expr.reg());
+    assign(expr, nullptr);
+}
+
+
+/*
+ * Function:	generate_field (private)
+ *
+ * Description:	Generate code to load a field of a structure, using a
+ *		single memory operand with the offset of the field folded
+ *		into its displacement.
+ */
+
+static void generate_field(Node field)
+{
+    Location loc;
+
+    generate_location(field, loc);
+    fetch(loc);
+
+    Register* reg = reuse(loc);
+
+    *output << "\tmov" << suffix(field) << loc << ", " << reg->name(field.type().size()) << endl;
+
+    discard(loc);
+    assign(field, reg);
+}
+
+
+
+
+/*
+ * Function:	align (private)
+ *
+ * Description:	Return the number of bytes necessary to align the given
+ *		offset on the stack.
+ */
+
+static int align(int offset)
+{
+    if (offset % STACK_ALIGNMENT == 0)
+	    return 0;
+
+    return STACK_ALIGNMENT - (abs(offset) % STACK_ALIGNMENT);
+}
+
+
+/*
+ * Function:	suffix (private)
+ *
+ * Description:	Return the suffix for an opcode based on the given size.
+ */
+
+static string suffix(unsigned long size)
+{
+    return size == 1 ? "b\t" : (size == 4 ? "l\t" : "q\t");
+}
+
+
+/*
+ * Function:	suffix (private)
+ *
+ * Description:	Return the suffix for an opcode based on the size of the
+ *		given expression.
+ */
+
+static string suffix(Node expr)
+{
+    return suffix(expr.type().size());
+}
+
+
+/*
+ * Function:	promote
+ *
+ * Description:	Keep the given variable in a register for its whole
+ *		lifetime if it may be and a register is still available,
+ *		and return whether it is.
+ */
+
+bool promote(Symbol* symbol)
+{
+    if (!promotable(symbol) || homes.empty())
+        return false;
+
+    take_home(symbol, homes[0]);
+    return true;
+}
+
+
+/*
+ * Function:	promotable (private)
+ *
+ * Description:	Return whether the given variable may be kept in a
+ *		register, which it may if it is a scalar whose address is
+ *		never taken.
+ */
+
+static bool promotable(const Symbol* symbol)
+{
+    const Type& type = symbol->type();
+
+    return !symbol->_escapes && type.isSimple() && type.isScalar();
+}
+
+
+/*
+ * Function:	take_home (private)
+ *
+ * Description:	Keep the given variable in the given register, which is
+ *		then no longer available for any other variable.
+ */
+
+static void take_home(Symbol* symbol, Register* reg)
+{
+    homes.erase(find(homes.begin(), homes.end(), reg));
+    variables.push_back(reg);
+    symbol->_register = reg;
+}
+
+
+/*
+ * Function:	home (private)
+ *
+ * Description:	Return the register holding the variable that is the given
+ *		expression, if any.
+ */
+
+static Register* home(Node expr)
+{
+    Symbol* symbol;
+
+    if (expr.isIdentifier(symbol))
+        return symbol->_register;
+
+    return nullptr;
+}
+
+
+/*
+ * Function:	touch (private)
+ *
+ * Description:	Note that the given register is being used, so that if it
+ *		is callee-saved then the function must save it.
+ */
 
-    cout << "\tmov" << suffix(_expr) << _expr << ", ";
-    cout << (_expr->type().size() == SIZEOF_LONG ? rax->as_qword() : rax->as_lword()) << endl;
-    cout << "\tjmp\t" << *return_label << endl;
-cout << "# --- retn\n";}
+static void touch(Register* reg)
+{
+    if (find(callee_saved.begin(), callee_saved.end(), reg) != callee_saved.end())
+        if (find(touched.begin(), touched.end(), reg) == touched.end())
+            touched.push_back(reg);
+}
 
 
-void While::generate()
-{cout << "# === whil\n";
-    Label loop, exit;
+/*
+ * Function:	where (private)
+ *
+ * Description:	Return the register holding the given expression, which is
+ *		either a temporary or the home of a variable.
+ */
 
-    cout << loop << ":" << endl;
+static Register* where(Node expr)
+{
+    Register* reg = expr.reg();
 
-    _expr->test(exit, false);
-    _stmt->generate();
+    if (reg == nullptr)
+    {
+        reg = home(expr);
+        touch(reg);
+    }
 
-    cout << "\tjmp\t" << loop << endl;
-    cout << exit << ":" << endl;
-cout << "# --- whil\n";}
+    return reg;
+}
 
 
-void If::generate()
-{cout << "# === if\n";
-    Label skip, exit;
+/*
+ * Function:	fetch (private)
+ *
+ * Description:	Make sure that the base and index of the given location are
+ *		in registers, reloading them if they were spilled.
+ */
 
-    _expr->test(skip, true);
-    _thenStmt->generate();
+static void fetch(Location& loc)
+{
+    if (loc.base && where(loc.base) == nullptr)
+        load(loc.base, get_reg(loc.index));
 
-    if (_elseStmt != nullptr)
-    {
-        cout << "\tjmp\t" << exit << endl;
-        cout << skip << ":" << endl;
+    if (loc.index && where(loc.index) == nullptr)
+        load(loc.index, get_reg(loc.base));
+}
 
-        _elseStmt->generate();
 
-        cout << exit << ":" << endl;
-    }
-    else
-        cout << skip << ":" << endl;
-        
-cout << "# --- if\n";}
+/*
+ * Function:	discard (private)
+ *
+ * Description:	Free the registers used by the given location.
+ */
+
+static void discard(Location& loc)
+{
+    if (loc.base)
+        assign(loc.base, nullptr);
+
+    if (loc.index)
+        assign(loc.index, nullptr);
+}
 
 
 /*
- * Function:	Assignment::generate
+ * Function:	reuse (private)
  *
- * Description:	Generate code for an assignment statement.
+ * Description:	Return a register for the result of an instruction that
+ *		uses the given location.  The base or index can be reused
+ *		if it is a temporary, but never the home of a variable.
  */
 
-void Assignment::generate()
-{cout << "# === asgn\n";
-    bool indirect = false;
+static Register* reuse(Location& loc)
+{
+    if (loc.base && loc.base.reg() != nullptr)
+        return loc.base.reg();
 
-    _left->generate_indirect(indirect);
-    _right->generate();
+    if (loc.index && loc.index.reg() != nullptr)
+        return loc.index.reg();
 
-    if (_right->_register == nullptr)
-        load(_right, get_reg());
+    return get_reg();
+}
 
-    if (indirect)
-    {
-        if (_left->_register == nullptr)
-            load(_left, get_reg());
 
-        cout << "\tmov" << suffix(_right) << _right << ", (" << _left->_register->as_qword() << ")" << endl;
-    }
-    else
-        cout << "\tmov" << suffix(_right) << _right << ", " << _left << endl;
+/*
+ * Function:	local (private)
+ *
+ * Description:	Return whether the given object is a local variable, and
+ *		so can be addressed relative to %rbp with an index.
+ */
+
+static bool local(Node object)
+{
+    Symbol* symbol;
+
+    return object.isIdentifier(symbol) && symbol->_offset != 0;
+}
+
+
+/*
+ * Function:	settle (private)
+ *
+ * Description:	Compute the given location, except for its displacement,
+ *		into a register owned by the given expression, which then
+ *		becomes the base of the location.
+ */
+
+static void settle(Location& loc, Node owner)
+{
+    long disp = loc.disp;
+
+    loc.disp = 0;
+    fetch(loc);
+
+    Register* reg = reuse(loc);
+
+    *output << "\tleaq\t" << loc << ", " << reg->as_qword() << endl;
 
-    assign(_left, nullptr);
-    assign(_right, nullptr);
+    if (loc.object && local(loc.object))
+        escaped = true;
 
-cout << "# --- asgn\n";}
+    discard(loc);
+    assign(owner, reg);
 
+    loc = Location();
+    loc.base = owner;
+    loc.disp = disp;
+}
+
+
+/*
+ * Function:	get_reg
+ *
+ * Description:	Returns the next register that is not currently being used.
+ *		If there is none, the value whose next use is furthest away
+ *		is spilled, except for the one we were asked to keep.
+ *
+ *		Each value in a register lives from the position at which
+ *		it is defined until its parent in the tree uses it.  Since
+ *		a tree is generated in postorder, these intervals nest, and
+ *		so the value defined first is the one used last.  Doing
+ *		this as we go is therefore the same as a linear scan over
+ *		the intervals that spills the one that ends furthest away.
+ */
 
-void Subtract::generate()
+Register* get_reg(Node keep)
 {
-    _left->generate();
-    _right->generate();
+    Register* victim = nullptr;
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+    for (unsigned i = 0; i < registers.size(); ++ i)
+        if (!registers[i]->_node)
+            return registers[i];
 
-    cout << "\tsub" << suffix(_left);
-    cout << _right << ", " << _left << endl;
+    for (unsigned i = 0; i < registers.size(); ++ i)
+        if (registers[i]->_node != keep || !keep)
+            if (victim == nullptr || registers[i]->_defined < victim->_defined)
+                victim = registers[i];
 
-    assign(_right, nullptr);
-    assign(this, _left->_register);
+    load(Node(), victim);
+    return victim;
 }
 
 
-void Add::generate()
+/*
+ * Function:	assign (private)
+ *
+ * Description:	Assign the given expression to the given register.  No
+ *		assembly code is generated here as only the pointers are
+ *		updated.  A spilled expression is either being reloaded or
+ *		is dead, so its slot is free for the next spill.
+ */
+
+static void assign(Node expr, Register* reg)
 {
-    _left->generate();
-    _right->generate();
+    if (expr)
+    {
+        if (expr.reg() != nullptr)
+            expr.reg()->_node = Node();
+        else if (expr.offset() != 0)
+        {
+            spill_slots.push_back(expr.offset());
+            expr.offset() = 0;
+        }
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+        expr.reg() = reg;
+    }
 
-    cout << "\tadd" << suffix(_left);
-    cout << _right << ", " << _left << endl;
+    if (reg != nullptr)
+    {
+        if (reg->_node)
+            reg->_node.reg() = nullptr;
 
-    assign(_right, nullptr);
-    assign(this, _left->_register);
+        reg->_node = expr;
+        reg->_defined = ++ position;
+    }
 }
 
 
-void Remainder::generate()
+/*
+ * Function:	vacate (private)
+ *
+ * Description:	Make room in the given register for a value that must be
+ *		there.  Any value already in it is moved to a free register
+ *		if there is one, and is otherwise spilled.  A division needs
+ *		both %rax and %rdx, so the value is never moved into either
+ *		one, as vacating the other would only move it back.
+ */
+
+static void vacate(Register* reg)
 {
-    _left->generate();
-    _right->generate();
+    Node expr = reg->_node;
+    unsigned defined = reg->_defined;
+
+    if (!expr)
+        return;
 
-    load(_left, rax);
+    for (unsigned i = 0; i < registers.size(); ++ i)
+        if (!registers[i]->_node && registers[i] != rax && registers[i] != rdx)
+        {
+            *output << "\tmovq\t" << reg->as_qword() << ", " << registers[i]->as_qword() << endl;
 
-    cout << "\tcltd" << endl;
-    cout << "\tidiv" << suffix(_right) << _right << endl;
+            assign(expr, registers[i]);
+            registers[i]->_defined = defined;
+            return;
+        }
 
-    assign(this, rdx);
+    load(Node(), reg);
 }
 
 
-void Divide::generate()
+/*
+ * Function:	load (private)
+ *
+ * Description:	Load the given expression into the given register.
+ */
+
+static void load(Node expr, Register* reg)
 {
-    _left->generate();
-    _right->generate();
+    if (reg->_node != expr)
+    {
+        if (reg->_node)
+            spill(reg);
+
+        if (expr)
+        {
+            unsigned size = expr.type().size();
+
+            Node object;
 
-    load(_left, rax);
+            if (expr.reg() == nullptr && expr.offset() != 0)
+                *output << "\tmovq\t" << expr.offset() << "(%rbp), " << reg->as_qword() << endl;
+            else if (expr.reg() == nullptr && expr.isAddress(object))
+            {
+                *output << "\tleaq\t" << object << ", " << reg->as_qword() << endl;
 
-    cout << "\tcltd" << endl;
-    cout << "\tidiv" << suffix(_right) << _right << endl;
+                if (local(object))
+                    escaped = true;
+            }
+            else
+            {
+                *output << "\tmov" << suffix(expr) << expr;
+                *output << ", " << reg->name(size) << endl;
+            }
+        }
 
-    assign(this, rax);
+        assign(expr, reg);
+    }
 }
 
 
-void Multiply::generate()
+/*
+ * Function:	spill (private)
+ *
+ * Description:	Free the given register by saving its contents on the
+ *		stack, unless they can simply be computed again.  Every
+ *		spill slot is a full aligned quadword, so that slots are
+ *		interchangeable and a freed one is reused by the next spill
+ *		instead of growing the frame.
+ */
+
+static void spill(Register* reg)
 {
-    _left->generate();
-    _right->generate();
+    Node expr = reg->_node;
+    bool dropped = recomputable(expr);
+
+    reg->_node = Node();
+    expr.reg() = nullptr;
 
-    if (_left->_register == nullptr)
-        load(_left, get_reg());
+    if (dropped)
+        return;
 
-    cout << "\timul" << suffix(_right) << _right << ", " << _left << endl;
+    if (spill_slots.empty())
+    {
+        offset -= SIZEOF_REG + (SIZEOF_REG - offset % SIZEOF_REG) % SIZEOF_REG;
+        expr.offset() = offset;
+    }
+    else
+    {
+        expr.offset() = spill_slots.back();
+        spill_slots.pop_back();
+    }
 
-    assign(_right, nullptr);
-    assign(this, _left->_register);
+    *output << "\tmovq\t" << reg->as_qword() << ", " << expr.offset() << "(%rbp)" << endl;
 }
 
 
-void Cast::generate()
-{cout << "# === cast\n";
-    _expr->generate();
+/*
+ * Function:	recomputable (private)
+ *
+ * Description:	Return whether the value of the given expression, which is
+ *		in a register, could be loaded again instead of being kept.
+ *		A number or the address of a variable never changes.  Only
+ *		a call can change a variable while an expression is being
+ *		evaluated, and it can only do so if the variable is global
+ *		or its address has been taken.
+ */
+
+static bool recomputable(Node expr)
+{
+    unsigned long value;
+    Node object;
+    Symbol* symbol;
+
+    if (expr.isNumber(value))
+        return true;
 
-    unsigned source = _expr->type().size();
-    unsigned target = _type.size();
+    if (expr.isAddress(object))
+        return object.reg() == nullptr && object.isIdentifier(symbol);
 
-    if (_expr->_register == nullptr)
-        load(_expr, get_reg());
+    if (expr.isIdentifier(symbol))
+        return symbol->_register != nullptr || (symbol->_offset != 0 && !symbol->_escapes);
 
-    if (target <= source)
-        assign(this, _expr->_register);
+    return false;
+}
+
+
+/*
+ * Function:	generate_operands (private)
+ *
+ * Description:	Generate the operands of a binary operator, starting with
+ *		the one that needs more registers, so that fewer values
+ *		are held at once.  Operands containing a call are always
+ *		generated left to right, so that calls and the variables
+ *		that they might change are evaluated in the same order as
+ *		before.  Both operands are left where they can be used.
+ */
+
+static void generate_operands(Node left, Node right)
+{
+    Node object;
+
+    if (!left.hasCall() && !right.hasCall() && right.need() > left.need())
+    {
+        right.generate();
+        left.generate();
+    }
     else
     {
-        cout << "\tmovslq\t" << _expr << ", " << _expr->_register->as_qword() << endl;
+        left.generate();
+        right.generate();
+    }
+
+
+    /* An address dropped to make room for the other operand cannot be
+       used where it is, and so must be computed again. */
+
+    if (left.reg() == nullptr && left.isAddress(object))
+        load(left, get_reg(right));
+
+    if (right.reg() == nullptr && right.isAddress(object))
+        load(right, get_reg(left));
+}
+
 
-        assign(this, _expr->_register);
-        assign(_expr, nullptr);
+/*
+ * Function:	power (private)
+ *
+ * Description:	Return the base-two logarithm of the given value if it is
+ *		a power of two, and -1 otherwise.
+ */
+
+static int power(unsigned long value)
+{
+    int log = 0;
+
+    if (value == 0 || (value & (value - 1)) != 0)
+        return -1;
+
+    while (value > 1)
+    {
+        value >>= 1;
+        ++ log;
     }
-cout << "# --- cast\n";}
+
+    return log;
+}
 
 
-void Address::generate()
-{cout << "# === addr\n";
-    _expr->generate();
+/*
+ * Function:	magic (private)
+ *
+ * Description:	Compute the multiplier and shift with which a signed value
+ *		of the given width can be divided by the given divisor,
+ *		which must be at least two, using a multiplication instead
+ *		(Warren, Hacker's Delight, section 10-4).  The multiplier
+ *		may have its sign bit set, in which case it stands for the
+ *		unsigned value and the dividend must be added back in.
+ */
 
-    if (_expr->type().indirection() == 0)
+static void magic(unsigned long divisor, unsigned bits, unsigned long& multiplier, unsigned& shift)
+{
+    unsigned long mask = bits == 64 ? ~0UL : (1UL << bits) - 1;
+    unsigned long two = 1UL << (bits - 1);
+    unsigned long anc = two - 1 - two % divisor;
+    unsigned long q1 = two / anc, r1 = two - q1 * anc;
+    unsigned long q2 = two / divisor, r2 = two - q2 * divisor;
+    unsigned long delta;
+    unsigned p = bits - 1;
+
+    do
     {
-        if (_expr->_register == nullptr)
+        ++ p;
+
+        q1 = (2 * q1) & mask;
+        r1 = 2 * r1;
+
+        if (r1 >= anc)
         {
-            cout << "\tleaq\t" << _expr << ", ";
-            assign(_expr, get_reg());
-            cout << _expr->_register->as_qword() << endl;
+            ++ q1;
+            r1 -= anc;
+        }
+
+        q2 = (2 * q2) & mask;
+        r2 = 2 * r2;
+
+        if (r2 >= divisor)
+        {
+            ++ q2;
+            r2 -= divisor;
         }
-        else
-            cout << "\tleaq\t(" << _expr->_register->as_qword() << "), " << _expr->_register->as_qword() << endl;
 
-        assign(this, _expr->_register);
-        assign(_expr, nullptr);
+        delta = divisor - r2;
     }
-cout << "# --- addr\n";}
+    while (q1 < delta || (q1 == delta && r1 == 0));
 
+    multiplier = (q2 + 1) & mask;
+    shift = p - bits;
+}
 
-void Dereference::generate()
-{cout << "# === deref\n";
-    _expr->generate();
 
-    if (_expr->_register == nullptr)
-        load(_expr, get_reg());
+/*
+ * Function:	divide_constant (private)
+ *
+ * Description:	Generate code for a signed division or remainder by a
+ *		constant without using idiv, which takes tens of cycles.
+ *		Return false if the divisor is not a suitable constant.
+ *
+ *		A power of two is a shift, or for a remainder a mask,
+ *		after adding a bias of one less than the divisor to a
+ *		negative dividend so that the result rounds toward zero.
+ *		Any other divisor is a multiplication by its magic number,
+ *		whose high half is in %rdx, and then a shift, with one
+ *		added for a negative dividend.  A remainder is then the
+ *		dividend less the quotient times the divisor.
+ */
 
-    cout << "\tmov" << suffix(_expr) << "(" << _expr << "), " << _expr << endl;
-    
-    assign(this, _expr->_register);
-    assign(_expr, nullptr);
-cout << "# --- deref\n";}
+static bool divide_constant(Node result, Node left, Node right, bool remainder)
+{
+    unsigned long value, multiplier;
+    unsigned size = left.type().size(), bits = size * 8, shift;
 
+    if (!right.isNumber(value))
+        return false;
 
-void Dereference::generate_indirect(bool& indirect)
-{cout << "# === * deref\n";
-    indirect = true;
+    long divisor = (size == SIZEOF_INT ? (int) value : (long) value);
+    unsigned long magnitude = divisor < 0 ? -(unsigned long) divisor : divisor;
+    int log = power(magnitude & (bits == 64 ? ~0UL : (1UL << bits) - 1));
 
-    _expr->generate();
+    if (divisor == 0 || (remainder && log > 31))
+        return false;
 
-    if (_expr->type().indirection() > 0)
+    if (log >= 0)
     {
-        if (_expr->_register == nullptr)
-            load(_expr, get_reg());
+        if (left.reg() == nullptr)
+            load(left, get_reg());
+
+        Register* reg = left.reg();
+
+        if (log == 0)
+        {
+            if (remainder)
+                *output << "\txor" << suffix(size) << reg->name(size) << ", " << reg->name(size) << endl;
+            else if (divisor < 0)
+                *output << "\tneg" << suffix(size) << reg->name(size) << endl;
+        }
+        else
+        {
+            Register* bias = get_reg(left);
+
+            *output << "\tmov" << suffix(size) << reg->name(size) << ", " << bias->name(size) << endl;
+
+            if (log > 1)
+                *output << "\tsar" << suffix(size) << "$" << bits - 1 << ", " << bias->name(size) << endl;
+
+            *output << "\tshr" << suffix(size) << "$" << bits - log << ", " << bias->name(size) << endl;
+            *output << "\tadd" << suffix(size) << bias->name(size) << ", " << reg->name(size) << endl;
+
+            if (remainder)
+            {
+                *output << "\tand" << suffix(size) << "$" << (1UL << log) - 1 << ", " << reg->name(size) << endl;
+                *output << "\tsub" << suffix(size) << bias->name(size) << ", " << reg->name(size) << endl;
+            }
+            else
+            {
+                *output << "\tsar" << suffix(size) << "$" << log << ", " << reg->name(size) << endl;
 
-        assign(this, _expr->_register);
+                if (divisor < 0)
+                    *output << "\tneg" << suffix(size) << reg->name(size) << endl;
+            }
+        }
+
+        assign(result, reg);
+        return true;
     }
 
-    assign(_expr, nullptr);
-cout << "# --- * deref\n";}
+    magic(magnitude, bits, multiplier, shift);
 
+    vacate(rdx);
+    vacate(rax);
 
-void Negate::generate()
-{
-    _expr->generate();
+    if (size == SIZEOF_INT)
+        *output << "\tmovl\t$" << (int) multiplier << ", %eax" << endl;
+    else if ((long) multiplier >= INT_MIN && (long) multiplier <= INT_MAX)
+        *output << "\tmovq\t$" << (long) multiplier << ", %rax" << endl;
+    else
+        *output << "\tmovabsq\t$" << (long) multiplier << ", %rax" << endl;
 
-    if (_expr->_register == nullptr)
-        load(_expr, get_reg());
+    assign(right, rax);
+    assign(result, rdx);
 
-    cout << "\tneg" << suffix(_expr) << _expr << endl;
+    if (left.isNumber(value))
+        load(left, get_reg());
 
-    assign(this, _expr->_register);
-    assign(_expr, nullptr);
-}
+    *output << "\timul" << suffix(size) << left << endl;
 
+    if (multiplier >> (bits - 1))
+        *output << "\tadd" << suffix(size) << left << ", " << rdx->name(size) << endl;
 
-void Not::generate()
-{
-    _expr->generate();
+    if (shift > 0)
+        *output << "\tsar" << suffix(size) << "$" << shift << ", " << rdx->name(size) << endl;
 
-    if (_expr->_register == nullptr)
-        load(_expr, get_reg());
+    *output << "\tmov" << suffix(size) << left << ", " << rax->name(size) << endl;
+    *output << "\tsar" << suffix(size) << "$" << bits - 1 << ", " << rax->name(size) << endl;
+    *output << "\tsub" << suffix(size) << rax->name(size) << ", " << rdx->name(size) << endl;
 
-    cout << "\tcmp" << suffix(_expr) << "\t$0, " << _expr << endl;
-    cout << "\tsete\t" << _expr->_register->as_byte() << endl;
-    cout << "\tmovzbl\t" << _expr->_register->as_byte() << ", " << _expr << endl;
+    if (remainder)
+    {
+        if (magnitude <= INT_MAX)
+            *output << "\timul" << suffix(size) << "$" << magnitude << ", " << rdx->name(size) << ", " << rdx->name(size) << endl;
+        else
+        {
+            *output << "\tmovabsq\t$" << magnitude << ", %rax" << endl;
+            *output << "\timulq\t%rax, %rdx" << endl;
+        }
 
-    assign(this, _expr->_register);
-    assign(_expr, nullptr);
-}
+        *output << "\tmov" << suffix(size) << left << ", " << rax->name(size) << endl;
+        *output << "\tsub" << suffix(size) << rdx->name(size) << ", " << rax->name(size) << endl;
 
+        assign(result, rax);
+    }
+    else if (divisor < 0)
+        *output << "\tneg" << suffix(size) << rdx->name(size) << endl;
 
-void Field::generate()
-{
+    assign(left, nullptr);
+    assign(right, nullptr);
 
+    return true;
 }
 
 
 /*
- * Function:	align (private)
+ * Function:	multiply_constant (private)
  *
- * Description:	Return the number of bytes necessary to align the given
- *		offset on the stack.
+ * Description:	Generate code for a multiplication by a small constant
+ *		using a shift, or a leal or leaq that multiplies by three,
+ *		five, or nine followed by a shift.  Return false if the
+ *		constant is not one of these.
  */
 
-static int align(int offset)
+static bool multiply_constant(Node result, Node left, Node right)
 {
-    if (offset % STACK_ALIGNMENT == 0)
-	    return 0;
+    static const long factors[] = { 9, 5, 3 };
 
-    return STACK_ALIGNMENT - (abs(offset) % STACK_ALIGNMENT);
+    unsigned long value;
+    unsigned size = result.type().size();
+    long factor = 1;
+    int log;
+
+    if (!right.isNumber(value))
+        return false;
+
+    long constant = (size == SIZEOF_INT ? (int) value : (long) value);
+
+    if (constant <= 0)
+        return false;
+
+    for (unsigned i = 0; i < 3 && factor == 1; ++ i)
+        if (constant % factors[i] == 0 && power(constant / factors[i]) >= 0)
+            factor = factors[i];
+
+    log = power(constant / factor);
+
+    if (log < 0)
+        return false;
+
+    if (left.reg() == nullptr)
+        load(left, get_reg());
+
+    Register* reg = left.reg();
+
+    if (factor > 1)
+    {
+        *output << "\tlea" << suffix(size) << "(" << reg->as_qword() << "," << reg->as_qword() << ",";
+        *output << factor - 1 << "), " << reg->name(size) << endl;
+    }
+
+    if (log > 0)
+        *output << "\tsal" << suffix(size) << "$" << log << ", " << reg->name(size) << endl;
+
+    assign(right, nullptr);
+    assign(result, reg);
+    return true;
 }
 
 
 /*
- * Function:	suffix (private)
+ * Function:	inverse (private)
  *
- * Description:	Return the suffix for an opcode based on the given size.
+ * Description:	Return the condition code that is true exactly when the
+ *		given one is false.
  */
 
-static string suffix(unsigned long size)
+static string inverse(const string& cc)
 {
-    return size == 1 ? "b\t" : (size == 4 ? "l\t" : "q\t");
+    static const string codes[][2] = {
+        { "e", "ne" }, { "l", "ge" }, { "g", "le" },
+    };
+
+    for (unsigned i = 0; i < 3; ++ i)
+    {
+        if (cc == codes[i][0])
+            return codes[i][1];
+
+        if (cc == codes[i][1])
+            return codes[i][0];
+    }
+
+    assert(false);
+    return cc;
 }
 
 
 /*
- * Function:	suffix (private)
+ * Function:	compare (private)
  *
- * Description:	Return the suffix for an opcode based on the size of the
- *		given expression.
+ * Description:	Generate code to compare the given operands, leaving only
+ *		the flags.
  */
 
-static string suffix(Expression* expr)
+static void compare(Node left, Node right)
 {
-    return suffix(expr->type().size());
+    generate_operands(left, right);
+
+    if (left.reg() == nullptr && home(left) == nullptr)
+        load(left, get_reg(right));
+
+    *output << "\tcmp" << suffix(left);
+    *output << right << ", " << left << endl;
+
+    assign(left, nullptr);
+    assign(right, nullptr);
 }
 
 
 /*
- * Function:	get_reg
+ * Function:	setcc (private)
  *
- * Description:	Returns the next register that is not currently being used.
+ * Description:	Turn the flags into the value of the given expression,
+ *		which is one if the condition code holds and zero if not.
+ *		Getting a register can spill but does not change the flags.
  */
 
-Register* get_reg()
+static void setcc(Node expr, const string& cc)
 {
-    for (unsigned i = 0; i < registers.size(); ++ i)
-        if (registers[i]->_node == nullptr)
-            return registers[i];
+    Register* reg = get_reg();
+
+    *output << "\tset" << cc << "\t" << reg->as_byte() << endl;
+    *output << "\tmovzbl\t" << reg->as_byte() << ", " << reg->as_lword() << endl;
 
-    load(nullptr, registers[0]);
-    return registers[0];
+    assign(expr, reg);
 }
 
 
 /*
- * Function:	assign (private)
+ * Function:	materialize (private)
  *
- * Description:	Assign the given expression to the given register.  No
- *		assembly code is generated here as only the pointers are
- *		updated.
+ * Description:	Generate code for the value of a logical operator, which
+ *		must short-circuit and so needs branches.  Any value live
+ *		in a register is spilled first, so that whatever either
+ *		operand spills or moves is the same on every path.
  */
 
-static void assign(Expression* expr, Register* reg)
+static void materialize(Node expr)
 {
-    if (expr != nullptr)
-    {
-        if (expr->_register != nullptr)
-            expr->_register->_node = nullptr;
+    Label skip, exit;
 
-        expr->_register = reg;
-    }
+    spill_live();
+    test(expr, skip, false);
 
-    if (reg != nullptr)
-    {
-        if (reg->_node != nullptr)
-            reg->_node->_register = nullptr;
+    Register* reg = get_reg();
 
-        reg->_node = expr;
-    }
+    *output << "\tmovl\t$1, " << reg->as_lword() << endl;
+    *output << "\tjmp\t" << exit << endl;
+    *output << skip << ":" << endl;
+    *output << "\tmovl\t$0, " << reg->as_lword() << endl;
+    *output << exit << ":" << endl;
+
+    assign(expr, reg);
 }
 
 
 /*
- * Function:	load (private)
+ * Function:	spill_live (private)
  *
- * Description:	Load the given expression into the given register.
+ * Description:	Spill every value that is live in a register.
  */
 
-static void load(Expression* expr, Register* reg)
+static void spill_live()
 {
-    if (reg->_node != expr)
-    {
-        if (reg->_node != nullptr)
-        {
-            unsigned size = reg->_node->type().size();
-
-            offset -= size;
-            reg->_node->_offset = offset;
-
-            cout << "\tmov" << suffix(reg->_node);
-            cout << reg->name(size) << ", ";
-            cout << offset << "(%rbp)" << endl;
-        }
-        
-        if (expr != nullptr)
-        {
-            unsigned size = expr->type().size();
-
-            cout << "\tmov" << suffix(expr) << expr;
-            cout << ", " << reg->name(size) << endl;
-        }
+    for (unsigned i = 0; i < caller_saved.size(); ++ i)
+        if (caller_saved[i]->_node)
+            load(Node(), caller_saved[i]);
 
-        assign(expr, reg);
-    }
+    for (unsigned i = 0; i < callee_saved.size(); ++ i)
+        if (callee_saved[i]->_node)
+            load(Node(), callee_saved[i]);
 }
@@ -9,8 +9,13 @@
 # ifndef GENERATOR_H
 # define GENERATOR_H
 
+# include <ostream>
 # include "Scope.h"
 
+extern thread_local std::ostream* output;
+
+void reset_generator();
 void generate_globals(Scope* scope);
+bool promote(Symbol* symbol);
 
 # endif /* GENERATOR_H */
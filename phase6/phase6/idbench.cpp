@@ -0,0 +1,204 @@
+/*
+ * File:	idbench.cpp
+ *
+ * Description:	This file contains the microbenchmark for keyword
+ *		recognition in the lexical analyzer for Simple C.  It links
+ *		only the lexer and its scanning kernels.
+ *
+ *		The corpus is read into memory and tokenized once to
+ *		collect its identifiers and keywords.  Each of them is then
+ *		recognized both by the std::map lookup that the lexer used
+ *		to do, a count() followed by operator[] on a copy of the
+ *		lexeme, and by the perfect hash that it does now.  The two
+ *		must agree on every lexeme.  Finally, the whole corpus is
+ *		tokenized again to give the throughput of the lexer itself.
+ *		Each time is the best of several runs.
+ *
+ *		usage: idbench corpus-file [runs]
+ */
+
+# include <map>
+# include <string>
+# include <vector>
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <fstream>
+# include <sstream>
+# include <iostream>
+# include "lexer.h"
+# include "tokens.h"
+
+using namespace std;
+
+
+/* The keyword table as the lexer used to have it */
+
+static map<string,int> keywords = {
+    {"auto", AUTO}, {"break", BREAK}, {"case", CASE}, {"char", CHAR},
+    {"const", CONST}, {"continue", CONTINUE}, {"default", DEFAULT},
+    {"do", DO}, {"double", DOUBLE}, {"else", ELSE}, {"enum", ENUM},
+    {"extern", EXTERN}, {"float", FLOAT}, {"for", FOR}, {"goto", GOTO},
+    {"if", IF}, {"int", INT}, {"long", LONG}, {"register", REGISTER},
+    {"return", RETURN}, {"short", SHORT}, {"signed", SIGNED},
+    {"sizeof", SIZEOF}, {"static", STATIC}, {"struct", STRUCT},
+    {"switch", SWITCH}, {"typedef", TYPEDEF}, {"union", UNION},
+    {"unsigned", UNSIGNED}, {"void", VOID}, {"volatile", VOLATILE},
+    {"while", WHILE},
+};
+
+static volatile long sink;
+
+
+/*
+ * Function:	seconds (private)
+ *
+ * Description:	Return the current time in seconds.
+ */
+
+static double seconds()
+{
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/*
+ * Function:	byMap (private)
+ *
+ * Description:	Recognize every lexeme the way the lexer used to.
+ */
+
+static long byMap(const vector<Lexeme> &words)
+{
+    long sum = 0;
+    string s;
+
+
+    for (unsigned i = 0; i < words.size(); i ++) {
+	s.assign(words[i].text, words[i].length);
+	sum += keywords.count(s) > 0 ? keywords[s] : ID;
+    }
+
+    return sum;
+}
+
+
+/*
+ * Function:	byHash (private)
+ *
+ * Description:	Recognize every lexeme the way the lexer does now.
+ */
+
+static long byHash(const vector<Lexeme> &words)
+{
+    long sum = 0;
+
+
+    for (unsigned i = 0; i < words.size(); i ++)
+	sum += keyword(words[i].text, words[i].length);
+
+    return sum;
+}
+
+
+/*
+ * Function:	byLexer (private)
+ *
+ * Description:	Tokenize the whole corpus.
+ */
+
+static long byLexer(const string &text)
+{
+    Lexeme lexbuf;
+    long sum = 0;
+    int token;
+
+
+    openSource(text.data(), text.size());
+
+    while ((token = lexan(lexbuf)) != DONE)
+	sum += token;
+
+    closeSource();
+    return sum;
+}
+
+
+/*
+ * Function:	best (private)
+ *
+ * Description:	Return the best time of the given number of runs of the
+ *		given function.
+ */
+
+template<class F>
+static double best(unsigned runs, F f)
+{
+    double start, t, min = 1e30;
+
+
+    for (unsigned i = 0; i < runs; i ++) {
+	start = seconds();
+	sink = f();
+	t = seconds() - start;
+
+	if (t < min)
+	    min = t;
+    }
+
+    return min;
+}
+
+
+int main(int argc, char *argv[])
+{
+    vector<Lexeme> words;
+    unsigned runs, mismatches = 0;
+    stringstream ss;
+    Lexeme lexbuf;
+    double t;
+    int token;
+
+
+    if (argc < 2) {
+	cerr << "usage: " << argv[0] << " corpus-file [runs]" << endl;
+	return 1;
+    }
+
+    ifstream in(argv[1]);
+    ss << in.rdbuf();
+
+    const string text = ss.str();
+    runs = (argc > 2 ? atoi(argv[2]) : 5);
+
+    openSource(text.data(), text.size());
+
+    while ((token = lexan(lexbuf)) != DONE)
+	if (token == ID || (token >= AUTO && token <= WHILE))
+	    words.push_back(lexbuf);
+
+    for (unsigned i = 0; i < words.size(); i ++) {
+	string s(words[i].text, words[i].length);
+
+	if ((keywords.count(s) > 0 ? keywords[s] : ID) != keyword(s.data(), s.size()))
+	    mismatches ++;
+    }
+
+    printf("%lu identifiers and keywords in %lu bytes\n", words.size(), text.size());
+
+    t = best(runs, [&] { return byMap(words); });
+    printf("std::map lookup\t%.3fs\t%.1f M/s\n", t, words.size() / t / 1e6);
+
+    t = best(runs, [&] { return byHash(words); });
+    printf("perfect hash\t%.3fs\t%.1f M/s\n", t, words.size() / t / 1e6);
+
+    t = best(runs, [&] { return byLexer(text); });
+    printf("whole lexer\t%.3fs\t%.1f MB/s\n", t, text.size() / t / 1e6);
+
+    if (mismatches > 0) {
+	printf("%u lexemes recognized differently\n", mismatches);
+	return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * File:	idcorpus.cpp
+ *
+ * Description:	This file contains the generator for the identifier-heavy
+ *		corpus used to benchmark keyword recognition in the lexical
+ *		analyzer for Simple C.
+ *
+ *		The corpus is written to the standard output as lines of
+ *		identifiers separated by blanks, with the occasional number
+ *		and punctuation so the lexer sees other tokens as well.
+ *		About a third of the identifiers are keywords, a third are
+ *		near misses that share the length and first or last
+ *		character of a keyword, and so land in the same slot of the
+ *		hash table, and the rest are ordinary names.  The same seed
+ *		always produces the same corpus.
+ *
+ *		usage: idcorpus [count [seed]]
+ */
+
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <string>
+
+using namespace std;
+
+static const char *keywords[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do",
+    "double", "else", "enum", "extern", "float", "for", "goto", "if",
+    "int", "long", "register", "return", "short", "signed", "sizeof",
+    "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while",
+};
+
+# define NUM_KEYWORDS (sizeof(keywords) / sizeof(keywords[0]))
+
+static unsigned long state;
+
+
+/*
+ * Function:	next (private)
+ *
+ * Description:	Return the next pseudo-random number below the given bound,
+ *		using a linear congruential generator so that the corpus
+ *		does not depend on the C library.
+ */
+
+static unsigned next(unsigned bound)
+{
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    return (state >> 33) % bound;
+}
+
+
+/*
+ * Function:	letter (private)
+ *
+ * Description:	Return a random character that may appear in the middle of
+ *		an identifier.
+ */
+
+static char letter()
+{
+    static const char chars[] =
+	"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+
+    return chars[next(sizeof(chars) - 1)];
+}
+
+
+/*
+ * Function:	identifier (private)
+ *
+ * Description:	Return the next identifier of the corpus.
+ */
+
+static string identifier()
+{
+    unsigned kind = next(3), n;
+    string s;
+
+
+    if (kind == 0)
+	return keywords[next(NUM_KEYWORDS)];
+
+    if (kind == 1) {
+	s = keywords[next(NUM_KEYWORDS)];
+	n = s.size() > 2 ? 1 + next(s.size() - 2) : s.size() - 1;
+	s[n] = (s[n] == 'x' ? 'y' : 'x');
+	return s;
+    }
+
+    n = 1 + next(12);
+    s += "abcdefghijklmnopqrstuvwxyz_"[next(27)];
+
+    while (s.size() < n)
+	s += letter();
+
+    return s;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned long count = 3000000, i;
+    unsigned column = 0;
+    string s;
+
+
+    if (argc > 1)
+	count = strtoul(argv[1], NULL, 0);
+
+    state = (argc > 2 ? strtoul(argv[2], NULL, 0) : 175);
+
+    for (i = 0; i < count; i ++) {
+	s = identifier();
+
+	if (next(8) == 0)
+	    s += (next(2) ? " 42" : " (");
+
+	column += s.size() + 1;
+	fputs(s.c_str(), stdout);
+
+	if (column > 72) {
+	    putchar('\n');
+	    column = 0;
+	} else
+	    putchar(' ');
+    }
+
+    putchar('\n');
+    return 0;
+}
@@ -3,63 +3,141 @@
  *
  * Description:	This file contains the public and private function and
  *		variable definitions for the lexical analyzer for Simple C.
+ *
+ *		The entire input is made available as a single buffer before
+ *		scanning begins.  If the input is a regular file, it is
+ *		memory-mapped; otherwise, it is read once in large blocks.
+ *		Lexemes are then simply views into that buffer, so scanning
+ *		a token never copies or allocates anything.
+ *
+ *		Several programs may be compiled at once on different
+ *		threads, so all of our state is kept per thread, and errors
+ *		are written to the diagnostic stream of the program being
+ *		compiled.
  */
 
-# include <map>
+# include <string>
 # include <cstdio>
-# include <cerrno>
+# include <climits>
+# include <cstring>
 # include <cctype>
 # include <cstdlib>
 # include <iostream>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
 # include "lexer.h"
+# include "scanner.h"
 # include "tokens.h"
 
 using namespace std;
-int numerrors, lineno = 1;
-
-
-/* Later, we will associate token values with each keyword */
-
-static map<string,int> keywords = {
-    {"auto", AUTO},
-    {"break", BREAK},
-    {"case", CASE},
-    {"char", CHAR},
-    {"const", CONST},
-    {"continue", CONTINUE},
-    {"default", DEFAULT},
-    {"do", DO},
-    {"double", DOUBLE},
-    {"else", ELSE},
-    {"enum", ENUM},
-    {"extern", EXTERN},
-    {"float", FLOAT},
-    {"for", FOR},
-    {"goto", GOTO},
-    {"if", IF},
-    {"int", INT},
-    {"long", LONG},
-    {"register", REGISTER},
-    {"return", RETURN},
-    {"short", SHORT},
-    {"signed", SIGNED},
-    {"sizeof", SIZEOF},
-    {"static", STATIC},
-    {"struct", STRUCT},
-    {"switch", SWITCH},
-    {"typedef", TYPEDEF},
-    {"union", UNION},
-    {"unsigned", UNSIGNED},
-    {"void", VOID},
-    {"volatile", VOLATILE},
-    {"while", WHILE},
+thread_local int numerrors, lineno = 1;
+thread_local ostream *diagnostics = &cerr;
+thread_local ostream *trace = nullptr;
+
+static thread_local const char *source, *cursor, *limit;
+static thread_local bool mapped;
+static thread_local string contents;
+
+
+/* The keywords, in the same order as their token values, so the token for
+   the keyword at index i is simply AUTO + i.  They are found using a
+   perfect hash computed from the first and last characters and the
+   length of the lexeme.  The hash table itself is built by the compiler,
+   and the build fails if the hash ever stops being perfect. */
+
+# define NUM_KEYWORDS 32
+# define MIN_KEYWORD 2
+# define MAX_KEYWORD 8
+# define HASH_SIZE 64
+
+static constexpr const char *keywords[NUM_KEYWORDS] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do",
+    "double", "else", "enum", "extern", "float", "for", "goto", "if",
+    "int", "long", "register", "return", "short", "signed", "sizeof",
+    "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while",
+};
+
+static constexpr unsigned length(const char *s)
+{
+    return *s ? 1 + length(s + 1) : 0;
+}
+
+static constexpr unsigned hashKeyword(const char *s, unsigned n)
+{
+    return (14 * (unsigned char) s[0] + 5 * (unsigned char) s[n - 1] + 5 * n)
+	& (HASH_SIZE - 1);
+}
+
+static constexpr int probe(unsigned h, unsigned i = 0)
+{
+    return i == NUM_KEYWORDS ? -1 :
+	hashKeyword(keywords[i], length(keywords[i])) == h ? i : probe(h, i + 1);
+}
+
+static constexpr bool isPerfect(unsigned i = 0)
+{
+    return i == NUM_KEYWORDS ||
+	(probe(hashKeyword(keywords[i], length(keywords[i]))) == (int) i &&
+	 isPerfect(i + 1));
+}
+
+static_assert(WHILE - AUTO + 1 == NUM_KEYWORDS, "keyword tokens out of order");
+static_assert(isPerfect(), "keyword hash has a collision");
+
+# define PROBE8(h) probe(h), probe(h + 1), probe(h + 2), probe(h + 3), \
+    probe(h + 4), probe(h + 5), probe(h + 6), probe(h + 7)
+
+static constexpr int slots[HASH_SIZE] = {
+    PROBE8(0), PROBE8(8), PROBE8(16), PROBE8(24),
+    PROBE8(32), PROBE8(40), PROBE8(48), PROBE8(56),
 };
 
 
+/*
+ * Function:	Lexeme::str
+ *
+ * Description:	Return a copy of this lexeme as a string.  This is the
+ *		only place a lexeme ever gets copied, and only the parser
+ *		calls it, when it needs to hold on to a name or value.
+ */
+
+string Lexeme::str() const
+{
+    return string(text, length);
+}
+
+
+/*
+ * Function:	keyword
+ *
+ * Description:	Return the token value for the given identifier, which is
+ *		either the token for the keyword it spells or ID.  Only one
+ *		string comparison is ever needed.
+ */
+
+int keyword(const char *s, unsigned n)
+{
+    int i;
+
+
+    if (n < MIN_KEYWORD || n > MAX_KEYWORD)
+	return ID;
+
+    i = slots[hashKeyword(s, n)];
+
+    if (i >= 0 && strncmp(keywords[i], s, n) == 0 && keywords[i][n] == '\0')
+	return AUTO + i;
+
+    return ID;
+}
+
+
 /*
  * Function:	report
  *
- * Description:	Report an error to the standard error prefixed with the
+ * Description:	Report an error to the diagnostic stream prefixed with the
  *		line number.  We'll be using this a lot later with an
  *		optional string argument, but C++'s stupid streams don't do
  *		positional arguments, so we actually resort to snprintf.
@@ -71,74 +149,178 @@ void report(const string &str, const string &arg)
     char buf[1000];
 
     snprintf(buf, sizeof(buf), str.c_str(), arg.c_str());
-    cerr << "line " << lineno << ": " << buf << endl;
+    *diagnostics << "line " << lineno << ": " << buf << endl;
     numerrors ++;
 }
 
 
+/*
+ * Function:	openSource
+ *
+ * Description:	Make the given file available as a single buffer and start
+ *		a new program at its first line.  A regular file is mapped
+ *		directly into memory, which avoids copying it at all.
+ *		Anything else, such as a pipe, is read in large blocks into
+ *		a string that we keep around until the source is closed.
+ */
+
+void openSource(int fd)
+{
+    struct stat info;
+    void *addr;
+    char block[65536];
+    ssize_t count;
+
+
+    closeSource();
+    lineno = 1;
+    numerrors = 0;
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+	addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	if (addr != MAP_FAILED) {
+	    source = static_cast<const char *>(addr);
+	    limit = source + info.st_size;
+	    cursor = source;
+	    mapped = true;
+	    return;
+	}
+    }
+
+    while ((count = read(fd, block, sizeof(block))) > 0)
+	contents.append(block, count);
+
+    source = contents.data();
+    limit = source + contents.size();
+    cursor = source;
+}
+
+
+/*
+ * Function:	openSource
+ *
+ * Description:	Start a new program at the first line of the given buffer,
+ *		which belongs to the caller and must not change or go away
+ *		until the source is closed.
+ */
+
+void openSource(const char *text, size_t length)
+{
+    closeSource();
+    lineno = 1;
+    numerrors = 0;
+
+    source = cursor = text;
+    limit = text + length;
+}
+
+
+/*
+ * Function:	closeSource
+ *
+ * Description:	Release the buffer holding the current source file, after
+ *		which no lexeme from it may be used.
+ */
+
+void closeSource()
+{
+    if (mapped)
+	munmap(const_cast<char *>(source), limit - source);
+
+    contents.clear();
+    source = cursor = limit = nullptr;
+    mapped = false;
+}
+
+
+/*
+ * Function:	tooLarge (private)
+ *
+ * Description:	Return whether the digits of a number do not fit in a long.
+ *		The value is accumulated directly from the buffer, as
+ *		strtol would read it, so that leading zeros do not count
+ *		against the length of the number: a leading zero means the
+ *		number is octal, and it ends at the first digit that is
+ *		not.
+ */
+
+static bool tooLarge(const char *p, const char *end)
+{
+    unsigned long value, base, digit;
+
+
+    value = 0;
+    base = (*p == '0' ? 8 : 10);
+
+    for (; p < end && (digit = *p - '0') < base; p ++) {
+	if (value > (LONG_MAX - digit) / base)
+	    return true;
+
+	value = value * base + digit;
+    }
+
+    return false;
+}
+
+
 /*
  * Function:	lexan
  *
- * Description:	Read and tokenize the standard input stream.  The lexeme is
- *		stored in a buffer.
+ * Description:	Tokenize the input buffer.  The lexeme is returned as a
+ *		view into the buffer and is valid until the source is
+ *		closed.
  */
 
-int lexan(string &lexbuf)
+int lexan(Lexeme &lexbuf)
 {
-    static int c = cin.get();
+    const char *start;
+    int c;
 
 
-    /* The invariant here is that the next character has already been read
-       and is ready to be classified.  In this way, we eliminate having to
-       push back characters onto the stream, merely to read them again. */
+    /* The invariant here is that the cursor points at the next character
+       to be classified.  Since the whole input is in memory, we can look
+       ahead as far as we like without having to push anything back. */
 
-    while (!cin.eof()) {
-	lexbuf.clear();
+    while (cursor < limit) {
 
 
 	/* Ignore white space */
 
-	while (isspace(c)) {
-	    if (c == '\n')
-		lineno ++;
+	cursor = skipSpace(cursor, limit, lineno);
 
-	    c = cin.get();
-	}
+	if (cursor == limit)
+	    break;
+
+	start = cursor;
+	c = (unsigned char) *cursor ++;
+	lexbuf.text = start;
 
 
 	/* Check for an identifier or a keyword */
 
 	if (isalpha(c) || c == '_') {
-	    do {
-		lexbuf += c;
-		c = cin.get();
-	    } while (isalnum(c) || c == '_');
-
-	    if (keywords.count(lexbuf) > 0)
-		return keywords[lexbuf];
+	    while (cursor < limit && (isalnum((unsigned char) *cursor)
+			|| *cursor == '_'))
+		cursor ++;
 
-	    return ID;
+	    lexbuf.length = cursor - start;
+	    return keyword(start, lexbuf.length);
 
 
 	/* Check for a number */
 
 	} else if (isdigit(c)) {
-	    do {
-		lexbuf += c;
-		c = cin.get();
-	    } while (isdigit(c));
+	    while (cursor < limit && isdigit((unsigned char) *cursor))
+		cursor ++;
 
-	    errno = 0;
-	    strtol(lexbuf.c_str(), NULL, 0);
-
-	    if (errno != 0)
+	    if (tooLarge(start, cursor))
 		report("integer constant too large");
 
-	    if (c == 'l' || c == 'L') {
-		lexbuf += c;
-		c = cin.get();
-	    }
+	    if (cursor < limit && (*cursor == 'l' || *cursor == 'L'))
+		cursor ++;
 
+	    lexbuf.length = cursor - start;
 	    return NUM;
 
 
@@ -148,7 +330,7 @@ int lexan(string &lexbuf)
 	   might as well do it now. */
 
 	} else {
-	    lexbuf += c;
+	    lexbuf.length = 1;
 
 	    switch(c) {
 
@@ -156,11 +338,9 @@ int lexan(string &lexbuf)
 	    /* Check for '||' */
 
 	    case '|':
-		c = cin.get();
-
-		if (c == '|') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '|') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return OR;
 		}
 
@@ -170,11 +350,9 @@ int lexan(string &lexbuf)
 	    /* Check for '=' and '==' */
 
 	    case '=':
-		c = cin.get();
-
-		if (c == '=') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '=') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return EQL;
 		}
 
@@ -184,11 +362,9 @@ int lexan(string &lexbuf)
 	    /* Check for '&' and '&&' */
 
 	    case '&':
-		c = cin.get();
-
-		if (c == '&') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '&') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return AND;
 		}
 
@@ -198,11 +374,9 @@ int lexan(string &lexbuf)
 	    /* Check for '!' and '!=' */
 
 	    case '!':
-		c = cin.get();
-
-		if (c == '=') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '=') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return NEQ;
 		}
 
@@ -212,11 +386,9 @@ int lexan(string &lexbuf)
 	    /* Check for '<' and '<=' */
 
 	    case '<':
-		c = cin.get();
-
-		if (c == '=') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '=') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return LEQ;
 		}
 
@@ -226,11 +398,9 @@ int lexan(string &lexbuf)
 	    /* Check for '>' and '>=' */
 
 	    case '>':
-		c = cin.get();
-
-		if (c == '=') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '=') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return GEQ;
 		}
 
@@ -240,16 +410,14 @@ int lexan(string &lexbuf)
 	    /* Check for '-', '--', and '->' */
 
 	    case '-':
-		c = cin.get();
-
-		if (c == '-') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '-') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return DEC;
 
-		} else if (c == '>') {
-		    lexbuf += c;
-		    c = cin.get();
+		} else if (cursor < limit && *cursor == '>') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return ARROW;
 		}
 
@@ -259,11 +427,9 @@ int lexan(string &lexbuf)
 	    /* Check for '+' and '++' */
 
 	    case '+':
-		c = cin.get();
-
-		if (c == '+') {
-		    lexbuf += c;
-		    c = cin.get();
+		if (cursor < limit && *cursor == '+') {
+		    lexbuf.length = 2;
+		    cursor ++;
 		    return INC;
 		}
 
@@ -275,35 +441,21 @@ int lexan(string &lexbuf)
 	    case '*': case '%': case ':': case ';':
 	    case '(': case ')': case '[': case ']':
 	    case '{': case '}': case '.': case ',':
-		c = cin.get();
-		return lexbuf[0];
+		return c;
 
 
 	    /* Check for '/' or a comment */
 
 	    case '/':
-		c = cin.get();
-
-		if (c == '*') {
-		    do {
-			while (c != '*' && !cin.eof()) {
-			    if (c == '\n')
-				lineno ++;
-
-			    c = cin.get();
-			}
-
-			c = cin.get();
-		    } while (c != '/' && !cin.eof());
-
-		    c = cin.get();
+		if (cursor < limit && *cursor == '*') {
+		    cursor = skipComment(cursor + 1, limit, lineno);
 		    break;
 
-		} else if (c == '/') {
-		    c = cin.get();
+		} else if (cursor < limit && *cursor == '/') {
+		    cursor = (const char *) memchr(cursor, '\n', limit - cursor);
 
-		    while (c != '\n' && !cin.eof())
-			c = cin.get();
+		    if (cursor == nullptr)
+			cursor = limit;
 
 		    break;
 
@@ -314,35 +466,57 @@ int lexan(string &lexbuf)
 	    /* Check for a string literal */
 
 	    case '"':
-		c = cin.get();
-
-		while (c != '"' && c != '\n' && !cin.eof()) {
-		    lexbuf += c;
-		    c = cin.get();
-		}
+		cursor = skipString(cursor, limit);
 
-		if (c == '\n' || cin.eof())
+		if (cursor == limit || *cursor == '\n')
 		    report("premature end of string literal");
+		else
+		    cursor ++;
 
-		lexbuf +=c ;
-		c = cin.get();
+		lexbuf.length = cursor - start;
 		return STRING;
 
 
-	    /* Handle EOF here as well */
-
-	    case EOF:
-		return false;
-
-
 	    /* Everything else is illegal */
 
 	    default:
-		c = cin.get();
 		break;
 	    }
 	}
     }
 
+    lexbuf.text = limit;
+    lexbuf.length = 0;
     return DONE;
 }
+
+
+/*
+ * Function:	tokenize
+ *
+ * Description:	Tokenize the entire input into the given token stream,
+ *		which is terminated by a DONE token.  Keeping this separate
+ *		from parsing means the parser can look ahead any number of
+ *		tokens, and that lexing can be timed on its own.
+ */
+
+void tokenize(TokenStream &tokens)
+{
+    Lexeme lexbuf;
+    int token;
+
+
+    tokens.text = source;
+    tokens.kinds.reserve((limit - source) / 8 + 1);
+    tokens.offsets.reserve((limit - source) / 8 + 1);
+    tokens.lengths.reserve((limit - source) / 8 + 1);
+    tokens.lines.reserve((limit - source) / 8 + 1);
+
+    do {
+	token = lexan(lexbuf);
+	tokens.kinds.push_back(token);
+	tokens.offsets.push_back(lexbuf.text - source);
+	tokens.lengths.push_back(lexbuf.length);
+	tokens.lines.push_back(lineno);
+    } while (token != DONE);
+}
@@ -3,15 +3,49 @@
  *
  * Description:	This file contains the public function and variable
  *		declarations for the lexical analyzer for Simple C.
+ *
+ *		A lexeme is a view into the input buffer rather than a
+ *		string of its own.  The buffer lives until the source is
+ *		closed, so the parser may keep a lexeme until then, but
+ *		must copy it if it wants a string.
+ *
+ *		The whole input can also be tokenized at once into a token
+ *		stream.  The stream is stored as separate arrays of token
+ *		values, offsets into the input buffer, lengths, and line
+ *		numbers, all indexed by the position of the token.
  */
 
 # ifndef LEXER_H
 # define LEXER_H
+# include <cstddef>
+# include <ostream>
 # include <string>
+# include <vector>
+
+struct Lexeme {
+    const char *text;
+    unsigned length;
+
+    std::string str() const;
+};
+
+struct TokenStream {
+    const char *text;
+    std::vector<short> kinds;
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> lengths;
+    std::vector<unsigned> lines;
+};
 
-extern int lineno, numerrors;
+extern thread_local int lineno, numerrors;
+extern thread_local std::ostream *diagnostics, *trace;
 
-int lexan(std::string &lexbuf);
+void openSource(int fd);
+void openSource(const char *text, std::size_t length);
+void closeSource();
+int keyword(const char *s, unsigned n);
+int lexan(Lexeme &lexbuf);
+void tokenize(TokenStream &tokens);
 void report(const std::string &str, const std::string &arg = "");
 
 # endif /* LEXER_H */
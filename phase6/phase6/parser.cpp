@@ -6,26 +6,83 @@
  *		Simple C.
  */
 
+# include <algorithm>
 # include <cstdlib>
 # include <iostream>
+# include <vector>
 # include "lexer.h"
 # include "tokens.h"
 # include "checker.h"
 # include "generator.h"
+# include "parser.h"
 
 using namespace std;
 
-static int lookahead;
-static string lexbuf;
+static thread_local int lookahead;
+static thread_local unsigned position;
+static thread_local TokenStream tokens;
 
-static Expression *expression();
-static Statement *statement(const Type &returnType);
+/* The deepest expression tree we accept.  The tree is written and
+   translated by recursive functions, so a much deeper one could overflow
+   the native stack of the thread compiling it. */
+
+static const unsigned max_depth = 4096;
+
+static Node statement(const Type &returnType);
+
+
+/*
+ * Function:	lexeme
+ *
+ * Description:	Return the lexeme of the lookahead token as a string.
+ */
+
+static string lexeme()
+{
+    return string(tokens.text + tokens.offsets[position],
+	tokens.lengths[position]);
+}
+
+
+/*
+ * Function:	peek
+ *
+ * Description:	Return the token the given number of tokens past the
+ *		lookahead token, or DONE if there is no such token.
+ */
+
+static int peek(unsigned n)
+{
+    if (position + n >= tokens.kinds.size())
+	return DONE;
+
+    return tokens.kinds[position + n];
+}
+
+
+/*
+ * Function:	advance
+ *
+ * Description:	Move to the next token in the stream, which becomes the
+ *		lookahead token.  The line number is updated as well, so
+ *		any errors are reported where the lookahead token is.
+ */
+
+static void advance()
+{
+    if (position + 1 < tokens.kinds.size())
+	position ++;
+
+    lookahead = tokens.kinds[position];
+    lineno = tokens.lines[position];
+}
 
 
 /*
  * Function:	error
  *
- * Description:	Report a syntax error to standard error.
+ * Description:	Report a syntax error and abandon the program being
+ *		compiled.
  */
 
 static void error()
@@ -33,9 +90,9 @@ static void error()
     if (lookahead == DONE)
 	report("syntax error at end of file");
     else
-	report("syntax error at '%s'", lexbuf);
+	report("syntax error at '%s'", lexeme());
 
-    exit(EXIT_FAILURE);
+    throw SyntaxError();
 }
 
 
@@ -43,7 +100,7 @@ static void error()
  * Function:	match
  *
  * Description:	Match the next token against the specified token.  A
- *		failure indicates a syntax error and will terminate the
+ *		failure indicates a syntax error and will abandon the
  *		program since our parser does not do error recovery.
  */
 
@@ -52,7 +109,7 @@ static void match(int t)
     if (lookahead != t)
 	error();
 
-    lookahead = lexan(lexbuf);
+    advance();
 }
 
 
@@ -67,7 +124,7 @@ static unsigned long number()
     string buf;
 
 
-    buf = lexbuf;
+    buf = lexeme();
     match(NUM);
     return strtoul(buf.c_str(), NULL, 0);
 }
@@ -76,17 +133,17 @@ static unsigned long number()
 /*
  * Function:	identifier
  *
- * Description:	Match the next token as an identifier and return its name.
+ * Description:	Match the next token as an identifier and return its name,
+ *		which is interned directly from the input buffer.
  */
 
-static string identifier()
+static Atom identifier()
 {
-    string buf;
+    Atom name(tokens.text + tokens.offsets[position], tokens.lengths[position]);
 
 
-    buf = lexbuf;
     match(ID);
-    return buf;
+    return name;
 }
 
 
@@ -114,16 +171,16 @@ static bool isSpecifier(int token)
  *		  struct identifier
  */
 
-static string specifier()
+static Atom specifier()
 {
     if (lookahead == INT) {
 	match(INT);
-	return "int";
+	return intAtom;
     }
 
     if (lookahead == LONG) {
 	match(LONG);
-	return "long";
+	return longAtom;
     }
 
     match(STRUCT);
@@ -166,10 +223,10 @@ static unsigned pointers()
  *		  pointers identifier [ num ]
  */
 
-static void declarator(const string &typespec)
+static void declarator(const Atom &typespec)
 {
     unsigned indirection;
-    string name;
+    Atom name(errorAtom);
 
 
     indirection = pointers();
@@ -201,7 +258,7 @@ static void declarator(const string &typespec)
 
 static void declaration()
 {
-    string typespec;
+    Atom typespec(errorAtom);
 
 
     typespec = specifier();
@@ -233,427 +290,454 @@ static void declarations()
 }
 
 
-/*
- * Function:	argument
- *
- * Description:	Parse an argument to a function call.  The only place
- *		string literals are allowed in Simple C is here, to
- *		enable calling printf(), scanf(), and the like.
- *
- *		argument:
- *		  string
- *		  expression
- */
+/* The kinds of frames on the expression stack.  Each frame is something
+   waiting for a subexpression to finish: a unary operator or a cast
+   waits for its prefix expression, a binary operator for its right
+   operand, and the rest for the expression inside their parentheses or
+   brackets.  The bottom frame of each expression waits for the entire
+   expression.  The arguments of all pending calls share a single stack,
+   and the depth of a call frame is that of its deepest argument so far. */
 
-static Expression *argument()
-{
-    Expression *expr;
+enum {
+    WHOLE, BINARY, UNARY, CAST, PARENTHESES, INDEX, CALL, SIZEOF_OPERAND
+};
 
+struct Frame {
+    int kind;
+    int token;
+    int power;
+    Node left;
+    Symbol *symbol;
+    unsigned first;
+    Atom typespec;
+    unsigned indirection;
+    unsigned depth;
 
-    if (lookahead != STRING)
-	return expression();
+    Frame(int kind, int token = 0, int power = 0, Node left = Node(),
+	    unsigned depth = 0)
+	: kind(kind), token(token), power(power), left(left),
+	  symbol(nullptr), first(0), typespec(errorAtom), indirection(0),
+	  depth(depth) {}
+};
 
-    expr = new String(lexbuf);
-    match(STRING);
-    return expr;
-}
+static thread_local vector<Frame> frames;
+static thread_local Expressions arguments;
 
 
 /*
- * Function:	primaryExpression
- *
- * Description:	Parse a primary expression.
- *
- *		primary-expression:
- *		  ( expression )
- *		  identifier ( argument-list )
- *		  identifier ( )
- *		  identifier
- *		  num
+ * Function:	bindingPower
  *
- *		argument-list:
- *		  argument
- *		  argument , argument-list
+ * Description:	Return how tightly the given token binds as a binary
+ *		operator, or zero if it is not one.  All of our binary
+ *		operators are left associative.
  */
 
-static Expression *primaryExpression(bool lparenMatched)
+static int bindingPower(int token)
 {
-    Expression *expr;
-    Symbol *symbol;
+    switch (token) {
+    case OR:
+	return 1;
 
+    case AND:
+	return 2;
 
-    if (lparenMatched) {
-	expr = expression();
-	match(')');
+    case EQL: case NEQ:
+	return 3;
 
-    } else if (lookahead == NUM) {
-	expr = new Number(lexbuf);
-	match(NUM);
+    case '<': case '>': case LEQ: case GEQ:
+	return 4;
 
-    } else if (lookahead == ID) {
-	symbol = checkIdentifier(identifier());
+    case '+': case '-':
+	return 5;
 
-	if (lookahead == '(') {
-	    Expressions args;
-	    match('(');
+    case '*': case '/': case '%':
+	return 6;
 
-	    if (lookahead != ')') {
-		args.push_back(argument());
-
-		while (lookahead == ',') {
-		    match(',');
-		    args.push_back(argument());
-		}
-	    }
-
-	    expr = checkCall(symbol, args);
-	    match(')');
-
-	} else
-	    expr = new Identifier(symbol);
-
-    } else {
-	expr = nullptr;
-	error();
+    default:
+	return 0;
     }
-
-    return expr;
 }
 
 
 /*
- * Function:	postfixExpression
+ * Function:	deeper
  *
- * Description:	Parse a postfix expression.
- *
- *		postfix-expression:
- *		  primary-expression
- *		  postfix-expression [ expression ]
- *		  postfix-expresion . identifier
- *		  postfix-expression -> identifier
+ * Description:	Return the depth of an expression whose deepest operand
+ *		has the given depth.  An expression too deep for us to
+ *		translate abandons the program like a syntax error.
  */
 
-static Expression *postfixExpression(bool lparenMatched)
+static unsigned deeper(unsigned depth)
 {
-    Expression *left, *right;
-
-
-    left = primaryExpression(lparenMatched);
-
-    while (1) {
-	if (lookahead == '[') {
-	    match('[');
-	    right = expression();
-	    left = checkArray(left, right);
-	    match(']');
-
-	} else if (lookahead == '.') {
-	    match('.');
-	    left = checkDirectField(left, identifier());
-
-	} else if (lookahead == ARROW) {
-	    match(ARROW);
-	    left = checkIndirectField(left, identifier());
-
-	} else
-	    break;
+    if (depth >= max_depth) {
+	report("expression nested too deeply");
+	throw SyntaxError();
     }
 
-    return left;
+    return depth + 1;
 }
 
 
 /*
- * Function:	prefixExpression
+ * Function:	checkBinary
  *
- * Description:	Parse a prefix expression.
- *
- *		prefix-expression:
- *		  postfix-expression
- *		  ! prefix-expression
- *		  - prefix-expression
- *		  * prefix-expression
- *		  & prefix-expression
- *		  sizeof ( expression )
- *		  ( specifier pointers ) prefix-expression
+ * Description:	Check a binary expression with the given operator.
  */
 
-static Expression *prefixExpression()
+static Node checkBinary(int token, Node left, Node right)
 {
-    Expression *expr;
-    string typespec;
-    unsigned indirection;
+    switch (token) {
+    case OR:
+	return checkLogicalOr(left, right);
 
+    case AND:
+	return checkLogicalAnd(left, right);
 
-    if (lookahead == '!') {
-	match('!');
-	expr = prefixExpression();
-	expr = checkNot(expr);
+    case EQL:
+	return checkEqual(left, right);
 
-    } else if (lookahead == '-') {
-	match('-');
-	expr = prefixExpression();
-	expr = checkNegate(expr);
+    case NEQ:
+	return checkNotEqual(left, right);
 
-    } else if (lookahead == '*') {
-	match('*');
-	expr = prefixExpression();
-	expr = checkDereference(expr);
+    case '<':
+	return checkLessThan(left, right);
 
-    } else if (lookahead == '&') {
-	match('&');
-	expr = prefixExpression();
-	expr = checkAddress(expr);
+    case '>':
+	return checkGreaterThan(left, right);
 
-    } else if (lookahead == SIZEOF) {
-	match(SIZEOF);
-	match('(');
-	expr = expression();
-	expr = checkSizeof(expr);
-	match(')');
+    case LEQ:
+	return checkLessOrEqual(left, right);
 
-    } else if (lookahead == '(') {
-	match('(');
+    case GEQ:
+	return checkGreaterOrEqual(left, right);
 
-	if (isSpecifier(lookahead)) {
-	    typespec = specifier();
-	    indirection = pointers();
-	    match(')');
-	    expr = prefixExpression();
-	    expr = checkCast(Type(typespec, indirection), expr);
+    case '+':
+	return checkAdd(left, right);
 
-	} else
-	    expr = postfixExpression(true);
+    case '-':
+	return checkSubtract(left, right);
 
-    } else
-	expr = postfixExpression(false);
+    case '*':
+	return checkMultiply(left, right);
+
+    case '/':
+	return checkDivide(left, right);
 
-    return expr;
+    default:
+	return checkRemainder(left, right);
+    }
 }
 
 
 /*
- * Function:	multiplicativeExpression
+ * Function:	checkUnary
  *
- * Description:	Parse a multiplicative expression.
- *
- *		multiplicative-expression:
- *		  prefix-expression
- *		  multiplicative-expression * prefix-expression
- *		  multiplicative-expression / prefix-expression
- *		  multiplicative-expression % prefix-expression
+ * Description:	Check a unary expression with the given operator.
  */
 
-static Expression *multiplicativeExpression()
+static Node checkUnary(int token, Node expr)
 {
-    Expression *left, *right;
+    switch (token) {
+    case '!':
+	return checkNot(expr);
 
+    case '-':
+	return checkNegate(expr);
 
-    left = prefixExpression();
+    case '*':
+	return checkDereference(expr);
 
-    while (1) {
-	if (lookahead == '*') {
-	    match('*');
-	    right = prefixExpression();
-	    left = checkMultiply(left, right);
-
-	} else if (lookahead == '/') {
-	    match('/');
-	    right = prefixExpression();
-	    left = checkDivide(left, right);
-
-	} else if (lookahead == '%') {
-	    match('%');
-	    right = prefixExpression();
-	    left = checkRemainder(left, right);
-
-	} else
-	    break;
+    default:
+	return checkAddress(expr);
     }
-
-    return left;
 }
 
 
 /*
- * Function:	additiveExpression
+ * Function:	expression
+ *
+ * Description:	Parse an expression, or more specifically, a logical-or
+ *		expression, since Simple C does not allow comma or
+ *		assignment as an expression operator.
+ *
+ *		expression:
+ *		  expression || expression
+ *		  expression && expression
+ *		  expression == expression
+ *		  expression != expression
+ *		  expression < expression
+ *		  expression > expression
+ *		  expression <= expression
+ *		  expression >= expression
+ *		  expression + expression
+ *		  expression - expression
+ *		  expression * expression
+ *		  expression / expression
+ *		  expression % expression
+ *		  prefix-expression
+ *
+ *		prefix-expression:
+ *		  ! prefix-expression
+ *		  - prefix-expression
+ *		  * prefix-expression
+ *		  & prefix-expression
+ *		  sizeof ( expression )
+ *		  ( specifier pointers ) prefix-expression
+ *		  postfix-expression
+ *
+ *		postfix-expression:
+ *		  primary-expression
+ *		  postfix-expression [ expression ]
+ *		  postfix-expression . identifier
+ *		  postfix-expression -> identifier
+ *
+ *		primary-expression:
+ *		  ( expression )
+ *		  identifier ( argument-list )
+ *		  identifier ( )
+ *		  identifier
+ *		  num
  *
- * Description:	Parse an additive expression.
+ *		argument-list:
+ *		  argument
+ *		  argument , argument-list
+ *
+ *		argument:
+ *		  string
+ *		  expression
  *
- *		additive-expression:
- *		  multiplicative-expression
- *		  additive-expression + multiplicative-expression
- *		  additive-expression - multiplicative-expression
+ *		The binary operators are parsed by precedence climbing, with
+ *		their precedence given by bindingPower().  Rather than
+ *		recursing for each subexpression, everything waiting for
+ *		one to finish is kept on an explicit stack of frames, so
+ *		parsing never runs out of native stack.  The depth of the
+ *		tree is tracked alongside, and is bounded by max_depth for
+ *		the passes that do recurse.  The checker is called in the
+ *		same order, and with the same lookahead token, as a
+ *		recursive-descent parser would.
  */
 
-static Expression *additiveExpression()
+static Node expression()
 {
-    Expression *left, *right;
+    enum { OPERAND, ARGUMENT, POSTFIX, PREFIXED, OPERATOR, COMPLETE };
+
+    vector<Frame> &stack = frames;
+    Expressions &args = arguments;
+    Node expr;
+    unsigned depth = 0;
+    int state = OPERAND;
+    Symbol *symbol;
+    Frame *top;
+    int power;
 
 
-    left = multiplicativeExpression();
+    stack.push_back(Frame(WHOLE));
+    top = &stack.back();
 
     while (1) {
-	if (lookahead == '+') {
-	    match('+');
-	    right = multiplicativeExpression();
-	    left = checkAdd(left, right);
+	switch (state) {
+
+
+	/* Parse any prefix operators, casts, and opening parentheses up to
+	   and including the next primary expression. */
+
+	case OPERAND:
+	    if (lookahead == '!' || lookahead == '-' || lookahead == '*'
+		    || lookahead == '&') {
+		stack.push_back(Frame(UNARY, lookahead));
+		top = &stack.back();
+		match(lookahead);
+
+	    } else if (lookahead == SIZEOF) {
+		match(SIZEOF);
+		match('(');
+		stack.push_back(Frame(SIZEOF_OPERAND));
+		top = &stack.back();
+
+	    } else if (lookahead == '(' && isSpecifier(peek(1))) {
+		match('(');
+		stack.push_back(Frame(CAST));
+		top = &stack.back();
+		top->typespec = specifier();
+		top->indirection = pointers();
+		match(')');
 
-	} else if (lookahead == '-') {
-	    match('-');
-	    right = multiplicativeExpression();
-	    left = checkSubtract(left, right);
+	    } else if (lookahead == '(') {
+		match('(');
+		stack.push_back(Frame(PARENTHESES));
+		top = &stack.back();
+
+	    } else if (lookahead == NUM) {
+		expr = Node::Number(lexeme());
+		depth = 1;
+		match(NUM);
+		state = POSTFIX;
+
+	    } else if (lookahead == ID) {
+		symbol = checkIdentifier(identifier());
+		depth = 1;
+		state = POSTFIX;
+
+		if (lookahead != '(')
+		    expr = Node::Identifier(symbol);
+
+		else {
+		    match('(');
+
+		    if (lookahead == ')') {
+			Expressions empty;
+
+			expr = checkCall(symbol, empty);
+			match(')');
+
+		    } else {
+			stack.push_back(Frame(CALL));
+			top = &stack.back();
+			top->symbol = symbol;
+			top->first = args.size();
+			state = ARGUMENT;
+		    }
+		}
+
+	    } else
+		error();
 
-	} else
 	    break;
-    }
 
-    return left;
-}
 
+	/* A string literal is allowed only as an argument, and is not an
+	   operand of anything else. */
 
-/*
- * Function:	relationalExpression
- *
- * Description:	Parse a relational expression.  Note that Simple C does not
- *		have shift operators, so we go immediately to additive
- *		expressions.
- *
- *		relational-expression:
- *		  additive-expression
- *		  relational-expression < additive-expression
- *		  relational-expression > additive-expression
- *		  relational-expression <= additive-expression
- *		  relational-expression >= additive-expression
- */
+	case ARGUMENT:
+	    if (lookahead == STRING) {
+		expr = Node::String(lexeme());
+		depth = 1;
+		match(STRING);
+		state = COMPLETE;
 
-static Expression *relationalExpression()
-{
-    Expression *left, *right;
+	    } else
+		state = OPERAND;
 
+	    break;
 
-    left = additiveExpression();
 
-    while (1) {
-	if (lookahead == '<') {
-	    match('<');
-	    right = additiveExpression();
-	    left = checkLessThan(left, right);
-
-	} else if (lookahead == '>') {
-	    match('>');
-	    right = additiveExpression();
-	    left = checkGreaterThan(left, right);
-
-	} else if (lookahead == LEQ) {
-	    match(LEQ);
-	    right = additiveExpression();
-	    left = checkLessOrEqual(left, right);
-
-	} else if (lookahead == GEQ) {
-	    match(GEQ);
-	    right = additiveExpression();
-	    left = checkGreaterOrEqual(left, right);
-
-	} else
-	    break;
-    }
+	/* Apply any postfix operators to the primary expression. */
 
-    return left;
-}
+	case POSTFIX:
+	    if (lookahead == '[') {
+		match('[');
+		stack.push_back(Frame(INDEX, '[', 0, expr, depth));
+		top = &stack.back();
+		state = OPERAND;
 
+	    } else if (lookahead == '.') {
+		match('.');
+		expr = checkDirectField(expr, identifier());
+		depth = deeper(depth);
 
-/*
- * Function:	equalityExpression
- *
- * Description:	Parse an equality expression.
- *
- *		equality-expression:
- *		  relational-expression
- *		  equality-expression == relational-expression
- *		  equality-expression != relational-expression
- */
+	    } else if (lookahead == ARROW) {
+		match(ARROW);
+		expr = checkIndirectField(expr, identifier());
+		depth = deeper(depth);
 
-static Expression *equalityExpression()
-{
-    Expression *left, *right;
+	    } else
+		state = PREFIXED;
 
+	    break;
 
-    left = relationalExpression();
 
-    while (1) {
-	if (lookahead == EQL) {
-	    match(EQL);
-	    right = relationalExpression();
-	    left = checkEqual(left, right);
+	/* Apply any prefix operators and casts, from the innermost out,
+	   since they bind more tightly than any binary operator. */
 
-	} else if (lookahead == NEQ) {
-	    match(NEQ);
-	    right = relationalExpression();
-	    left = checkNotEqual(left, right);
+	case PREFIXED:
+	    while (top->kind == UNARY || top->kind == CAST) {
+		if (top->kind == UNARY)
+		    expr = checkUnary(top->token, expr);
+		else
+		    expr = checkCast(Type(top->typespec, top->indirection), expr);
+
+		depth = deeper(depth);
+
+		stack.pop_back();
+		top = &stack.back();
+	    }
 
-	} else
+	    state = OPERATOR;
 	    break;
-    }
 
-    return left;
-}
 
+	/* Reduce every pending binary operator that binds at least as
+	   tightly as the next one, and then either wait for the right
+	   operand of the next one or finish the expression. */
 
-/*
- * Function:	logicalAndExpression
- *
- * Description:	Parse a logical-and expression.  Note that Simple C does
- *		not have bitwise-and expressions.
- *
- *		logical-and-expression:
- *		  equality-expression
- *		  logical-and-expression && equality-expression
- */
+	case OPERATOR:
+	    power = bindingPower(lookahead);
 
-static Expression *logicalAndExpression()
-{
-    Expression *left, *right;
+	    while (top->kind == BINARY && top->power >= power) {
+		expr = checkBinary(top->token, top->left, expr);
+		depth = deeper(max(top->depth, depth));
+		stack.pop_back();
+		top = &stack.back();
+	    }
 
+	    if (power > 0) {
+		stack.push_back(Frame(BINARY, lookahead, power, expr, depth));
+		top = &stack.back();
+		match(lookahead);
+		state = OPERAND;
 
-    left = equalityExpression();
+	    } else
+		state = COMPLETE;
 
-    while (lookahead == AND) {
-	match(AND);
-	right = equalityExpression();
-	left = checkLogicalAnd(left, right);
-    }
+	    break;
 
-    return left;
-}
 
+	/* Hand a complete expression to whatever was waiting for it. */
 
-/*
- * Function:	expression
- *
- * Description:	Parse an expression, or more specifically, a logical-or
- *		expression, since Simple C does not allow comma or
- *		assignment as an expression operator.
- *
- *		expression:
- *		  logical-and-expression
- *		  expression || logical-and-expression
- */
+	case COMPLETE:
+	    if (top->kind == WHOLE) {
+		stack.pop_back();
+		return expr;
 
-static Expression *expression()
-{
-    Expression *left, *right;
+	    } else if (top->kind == PARENTHESES) {
+		match(')');
+		state = POSTFIX;
 
+	    } else if (top->kind == INDEX) {
+		expr = checkArray(top->left, expr);
+		depth = deeper(max(top->depth, depth));
+		match(']');
+		state = POSTFIX;
 
-    left = logicalAndExpression();
+	    } else if (top->kind == SIZEOF_OPERAND) {
+		expr = checkSizeof(expr);
+		depth = 1;
+		match(')');
+		state = PREFIXED;
 
-    while (lookahead == OR) {
-	match(OR);
-	right = logicalAndExpression();
-	left = checkLogicalOr(left, right);
-    }
+	    } else if (lookahead == ',') {
+		args.push_back(expr);
+		top->depth = max(top->depth, depth);
+		match(',');
+		state = ARGUMENT;
+		break;
 
-    return left;
+	    } else {
+		Expressions list(args.begin() + top->first, args.end());
+
+		list.push_back(expr);
+		args.resize(top->first);
+		expr = checkCall(top->symbol, list);
+		depth = deeper(max(top->depth, depth));
+		match(')');
+		state = POSTFIX;
+	    }
+
+	    stack.pop_back();
+	    top = &stack.back();
+	    break;
+	}
+    }
 }
 
 
@@ -698,11 +782,11 @@ static Statements statements(const Type &returnType)
  *		  expression ;
  */
 
-static Statement *statement(const Type &returnType)
+static Node statement(const Type &returnType)
 {
     Scope *decls;
-    Expression *expr;
-    Statement *stmt;
+    Node expr;
+    Node stmt;
     Statements stmts;
 
 
@@ -713,7 +797,7 @@ static Statement *statement(const Type &returnType)
 	stmts = statements(returnType);
 	decls = closeScope();
 	match('}');
-	return new Block(decls, stmts);
+	return Node::Block(decls, stmts);
     }
     
     if (lookahead == RETURN) {
@@ -721,7 +805,7 @@ static Statement *statement(const Type &returnType)
 	expr = expression();
 	checkReturn(expr, returnType);
 	match(';');
-	return new Return(expr);
+	return Node::Return(expr);
     }
     
     if (lookahead == WHILE) {
@@ -731,7 +815,7 @@ static Statement *statement(const Type &returnType)
 	checkTest(expr);
 	match(')');
 	stmt = statement(returnType);
-	return new While(expr, stmt);
+	return Node::While(expr, stmt);
     }
     
     if (lookahead == IF) {
@@ -743,10 +827,10 @@ static Statement *statement(const Type &returnType)
 	stmt = statement(returnType);
 
 	if (lookahead != ELSE)
-	    return new If(expr, stmt, nullptr);
+	    return Node::If(expr, stmt, Node());
 
 	match(ELSE);
-	return new If(expr, stmt, statement(returnType));
+	return Node::If(expr, stmt, statement(returnType));
     }
 
     expr = expression();
@@ -755,7 +839,7 @@ static Statement *statement(const Type &returnType)
 	match('=');
 	stmt = checkAssignment(expr, expression());
     } else
-	stmt = new Simple(expr);
+	stmt = Node::Simple(expr);
 
     match(';');
     return stmt;
@@ -774,7 +858,7 @@ static Statement *statement(const Type &returnType)
 
 static Type parameter()
 {
-    string typespec, name;
+    Atom typespec(errorAtom), name(errorAtom);
     unsigned indirection;
 
 
@@ -803,20 +887,20 @@ static Type parameter()
  *		  parameter , parameter-list
  */
 
-static Parameters *parameters()
+static Parameters parameters()
 {
-    Parameters *params = new Parameters();
+    Parameters params;
 
 
     if (lookahead == VOID)
 	match(VOID);
 
     else {
-	params->push_back(parameter());
+	params.push_back(parameter());
 
 	while (lookahead == ',') {
 	    match(',');
-	    params->push_back(parameter());
+	    params.push_back(parameter());
 	}
     }
 
@@ -837,10 +921,10 @@ static Parameters *parameters()
  *		  pointers identifier [ num ]
  */
 
-static void globalDeclarator(const string &typespec)
+static void globalDeclarator(const Atom &typespec)
 {
     unsigned indirection;
-    string name;
+    Atom name(errorAtom);
 
 
     indirection = pointers();
@@ -871,7 +955,7 @@ static void globalDeclarator(const string &typespec)
  * 		  , global-declarator remaining-declarators
  */
 
-static void remainingDeclarators(const string &typespec)
+static void remainingDeclarators(const Atom &typespec)
 {
     while (lookahead == ',') {
 	match(',');
@@ -897,13 +981,13 @@ static void remainingDeclarators(const string &typespec)
 
 static void globalOrFunction()
 {
-    string typespec, name;
+    Atom typespec(errorAtom), name(errorAtom);
     unsigned indirection;
 
 
     typespec = specifier();
 
-    if (typespec != "int" && typespec != "long" && lookahead == '{') {
+    if (typespec != intAtom && typespec != longAtom && lookahead == '{') {
 	openStruct(typespec);
 	match('{');
 	declaration();
@@ -934,12 +1018,12 @@ static void globalOrFunction()
 		Scope *decls;
 		Symbol *symbol;
 		Statements stmts;
-		Parameters *params;
-		Function *function;
+		Parameters params;
+		Node function;
 
 		openScope();
 		params = parameters();
-		symbol = defineFunction(name, Type(typespec, indirection, params));
+		symbol = defineFunction(name, Type(typespec, indirection, &params));
 		match(')');
 		match('{');
 		declarations();
@@ -947,12 +1031,16 @@ static void globalOrFunction()
 		decls = closeScope();
 		match('}');
 
-		function = new Function(symbol, new Block(decls, stmts));
-		function->write(cerr);
-		cerr << endl << endl;
+		function = Node::Function(symbol, Node::Block(decls, stmts));
+		if (trace != nullptr) {
+		    function.write(*trace);
+		    *trace << endl << endl;
+		}
 
 		if (numerrors == 0)
-		    function->generate();
+		    function.generate();
+
+		Node::release();
 	    }
 
 	} else {
@@ -964,19 +1052,34 @@ static void globalOrFunction()
 
 
 /*
- * Function:	main
+ * Function:	parse
  *
- * Description:	Analyze the standard input stream.
+ * Description:	Analyze the current source file and generate code for it.
+ *		The input is first tokenized in its entirety and then
+ *		parsed.  Any state left over from a previous program,
+ *		including one abandoned because of a syntax error, is
+ *		discarded first.
  */
 
-int main()
+void parse()
 {
+    Node::release();
+    resetChecker();
+    reset_generator();
+
+    tokens = TokenStream();
+    position = 0;
+    frames.clear();
+    arguments.clear();
+
+    tokenize(tokens);
+    lookahead = tokens.kinds[0];
+    lineno = tokens.lines[0];
+
     openScope();
-    lookahead = lexan(lexbuf);
 
     while (lookahead != DONE)
 	globalOrFunction();
 
     generate_globals(closeScope());
-    exit(EXIT_SUCCESS);
 }
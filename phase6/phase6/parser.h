@@ -0,0 +1,19 @@
+/*
+ * File:	parser.h
+ *
+ * Description:	This file contains the public function declarations for the
+ *		recursive-descent parser for Simple C.
+ */
+
+# ifndef PARSER_H
+# define PARSER_H
+
+/* Thrown when a syntax error is found.  The error has already been
+   reported by the time this is caught. */
+
+struct SyntaxError {
+};
+
+void parse();
+
+# endif /* PARSER_H */
@@ -0,0 +1,397 @@
+/*
+ * File:	scanner.cpp
+ *
+ * Description:	This file contains the public and private function
+ *		definitions for the scanning kernels used by the lexical
+ *		analyzer for Simple C.
+ *
+ *		Every kernel has a scalar implementation, which is the
+ *		reference, and an SSE2 and an AVX2 implementation, which
+ *		examine 16 or 32 characters at once.  The vector versions
+ *		build a bit mask with one bit per character, so finding the
+ *		first interesting character is a count of trailing zeros
+ *		and counting the newlines skipped is a population count.
+ *		Any characters left over at the end of the buffer are
+ *		handed to the scalar version, so we never read past the
+ *		limit.
+ *
+ *		The implementation is selected once at startup by asking
+ *		the processor (via CPUID) what it supports.
+ */
+
+# include <cctype>
+# include "scanner.h"
+
+# if defined(__x86_64__)
+# include <immintrin.h>
+# define HAVE_SIMD 1
+# endif
+
+
+/*
+ * Function:	scalarSpace (private)
+ *
+ * Description:	Skip white space one character at a time.
+ */
+
+static const char *scalarSpace(const char *p, const char *limit, int &lines)
+{
+    while (p < limit && isspace((unsigned char) *p)) {
+	if (*p == '\n')
+	    lines ++;
+
+	p ++;
+    }
+
+    return p;
+}
+
+
+/*
+ * Function:	scalarComment (private)
+ *
+ * Description:	Skip the body of a block comment one character at a time,
+ *		including the closing delimiter.
+ */
+
+static const char *scalarComment(const char *p, const char *limit, int &lines)
+{
+    while (p < limit) {
+	if (*p == '\n')
+	    lines ++;
+
+	else if (*p == '*' && p + 1 < limit && p[1] == '/')
+	    return p + 2;
+
+	p ++;
+    }
+
+    return limit;
+}
+
+
+/*
+ * Function:	scalarString (private)
+ *
+ * Description:	Skip the body of a string literal one character at a time,
+ *		stopping at the closing quote or at a newline.
+ */
+
+static const char *scalarString(const char *p, const char *limit)
+{
+    while (p < limit && *p != '"' && *p != '\n')
+	p ++;
+
+    return p;
+}
+
+
+# ifdef HAVE_SIMD
+
+/*
+ * Function:	sse2Space (private)
+ *
+ * Description:	Skip white space sixteen characters at a time.  A
+ *		character is white space if it is a blank or lies between a
+ *		tab and a carriage return; the latter is checked with a
+ *		single unsigned comparison after subtracting a tab.
+ */
+
+static const char *sse2Space(const char *p, const char *limit, int &lines)
+{
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i range = _mm_set1_epi8('\r' - '\t');
+    __m128i c, d, ws;
+    unsigned stop, nl, n;
+
+
+    while (limit - p >= 16) {
+	c = _mm_loadu_si128((const __m128i *) p);
+	d = _mm_sub_epi8(c, tab);
+	ws = _mm_cmpeq_epi8(_mm_min_epu8(d, range), d);
+	ws = _mm_or_si128(ws, _mm_cmpeq_epi8(c, blank));
+
+	stop = ~_mm_movemask_epi8(ws) & 0xffff;
+	nl = _mm_movemask_epi8(_mm_cmpeq_epi8(c, newline));
+
+	if (stop != 0) {
+	    n = __builtin_ctz(stop);
+	    lines += __builtin_popcount(nl & ((1u << n) - 1));
+	    return p + n;
+	}
+
+	lines += __builtin_popcount(nl);
+	p += 16;
+    }
+
+    return scalarSpace(p, limit, lines);
+}
+
+
+/*
+ * Function:	sse2Comment (private)
+ *
+ * Description:	Skip the body of a block comment sixteen characters at a
+ *		time.  Comparing the block against '*' and the block one
+ *		character later against '/' finds a closing delimiter even
+ *		if it straddles two blocks.
+ */
+
+static const char *sse2Comment(const char *p, const char *limit, int &lines)
+{
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i newline = _mm_set1_epi8('\n');
+    __m128i c, d;
+    unsigned stop, nl, n;
+
+
+    while (limit - p >= 17) {
+	c = _mm_loadu_si128((const __m128i *) p);
+	d = _mm_loadu_si128((const __m128i *) (p + 1));
+
+	stop = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(c, star),
+		    _mm_cmpeq_epi8(d, slash)));
+	nl = _mm_movemask_epi8(_mm_cmpeq_epi8(c, newline));
+
+	if (stop != 0) {
+	    n = __builtin_ctz(stop);
+	    lines += __builtin_popcount(nl & ((1u << n) - 1));
+	    return p + n + 2;
+	}
+
+	lines += __builtin_popcount(nl);
+	p += 16;
+    }
+
+    return scalarComment(p, limit, lines);
+}
+
+
+/*
+ * Function:	sse2String (private)
+ *
+ * Description:	Skip the body of a string literal sixteen characters at a
+ *		time.
+ */
+
+static const char *sse2String(const char *p, const char *limit)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    __m128i c;
+    unsigned stop;
+
+
+    while (limit - p >= 16) {
+	c = _mm_loadu_si128((const __m128i *) p);
+	stop = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, quote),
+		    _mm_cmpeq_epi8(c, newline)));
+
+	if (stop != 0)
+	    return p + __builtin_ctz(stop);
+
+	p += 16;
+    }
+
+    return scalarString(p, limit);
+}
+
+
+/*
+ * Function:	avx2Space (private)
+ *
+ * Description:	Skip white space thirty-two characters at a time.
+ */
+
+__attribute__((target("avx2,popcnt")))
+static const char *avx2Space(const char *p, const char *limit, int &lines)
+{
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i range = _mm256_set1_epi8('\r' - '\t');
+    __m256i c, d, ws;
+    unsigned stop, nl, n;
+
+
+    while (limit - p >= 32) {
+	c = _mm256_loadu_si256((const __m256i *) p);
+	d = _mm256_sub_epi8(c, tab);
+	ws = _mm256_cmpeq_epi8(_mm256_min_epu8(d, range), d);
+	ws = _mm256_or_si256(ws, _mm256_cmpeq_epi8(c, blank));
+
+	stop = ~(unsigned) _mm256_movemask_epi8(ws);
+	nl = _mm256_movemask_epi8(_mm256_cmpeq_epi8(c, newline));
+
+	if (stop != 0) {
+	    n = __builtin_ctz(stop);
+	    lines += __builtin_popcount(nl & ((1u << n) - 1));
+	    return p + n;
+	}
+
+	lines += __builtin_popcount(nl);
+	p += 32;
+    }
+
+    return sse2Space(p, limit, lines);
+}
+
+
+/*
+ * Function:	avx2Comment (private)
+ *
+ * Description:	Skip the body of a block comment thirty-two characters at
+ *		a time.
+ */
+
+__attribute__((target("avx2,popcnt")))
+static const char *avx2Comment(const char *p, const char *limit, int &lines)
+{
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i c, d;
+    unsigned stop, nl, n;
+
+
+    while (limit - p >= 33) {
+	c = _mm256_loadu_si256((const __m256i *) p);
+	d = _mm256_loadu_si256((const __m256i *) (p + 1));
+
+	stop = _mm256_movemask_epi8(_mm256_and_si256(
+		    _mm256_cmpeq_epi8(c, star), _mm256_cmpeq_epi8(d, slash)));
+	nl = _mm256_movemask_epi8(_mm256_cmpeq_epi8(c, newline));
+
+	if (stop != 0) {
+	    n = __builtin_ctz(stop);
+	    lines += __builtin_popcount(nl & ((1u << n) - 1));
+	    return p + n + 2;
+	}
+
+	lines += __builtin_popcount(nl);
+	p += 32;
+    }
+
+    return sse2Comment(p, limit, lines);
+}
+
+
+/*
+ * Function:	avx2String (private)
+ *
+ * Description:	Skip the body of a string literal thirty-two characters at
+ *		a time.
+ */
+
+__attribute__((target("avx2")))
+static const char *avx2String(const char *p, const char *limit)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i c;
+    unsigned stop;
+
+
+    while (limit - p >= 32) {
+	c = _mm256_loadu_si256((const __m256i *) p);
+	stop = _mm256_movemask_epi8(_mm256_or_si256(
+		    _mm256_cmpeq_epi8(c, quote), _mm256_cmpeq_epi8(c, newline)));
+
+	if (stop != 0)
+	    return p + __builtin_ctz(stop);
+
+	p += 32;
+    }
+
+    return sse2String(p, limit);
+}
+
+# endif /* HAVE_SIMD */
+
+
+/* The selected implementation of each kernel */
+
+struct Kernels {
+    const char *(*space)(const char *, const char *, int &);
+    const char *(*comment)(const char *, const char *, int &);
+    const char *(*string)(const char *, const char *);
+};
+
+
+/*
+ * Function:	selectKernels (private)
+ *
+ * Description:	Return the best implementation of the kernels that the
+ *		processor we're running on supports.
+ */
+
+static Kernels selectKernels()
+{
+# ifdef HAVE_SIMD
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+	return { avx2Space, avx2Comment, avx2String };
+
+    if (__builtin_cpu_supports("sse2"))
+	return { sse2Space, sse2Comment, sse2String };
+# endif
+
+    return { scalarSpace, scalarComment, scalarString };
+}
+
+static const Kernels kernels = selectKernels();
+
+
+/*
+ * Function:	skipSpace
+ *
+ * Description:	Skip any white space, adding the number of newlines
+ *		skipped to the given line count.  Most white space is a
+ *		single blank between two tokens, or none at all, which is
+ *		not worth loading a vector for.
+ */
+
+const char *skipSpace(const char *p, const char *limit, int &lines)
+{
+    if (p < limit && *p == ' ')
+	p ++;
+
+    if (p == limit || !isspace((unsigned char) *p))
+	return p;
+
+    return kernels.space(p, limit, lines);
+}
+
+
+/*
+ * Function:	skipComment
+ *
+ * Description:	Skip the body of a block comment, which starts just after
+ *		the opening delimiter, up to and including its closing
+ *		delimiter, adding the number of newlines skipped to the
+ *		given line count.  An unterminated comment runs to the
+ *		limit.
+ */
+
+const char *skipComment(const char *p, const char *limit, int &lines)
+{
+    return kernels.comment(p, limit, lines);
+}
+
+
+/*
+ * Function:	skipString
+ *
+ * Description:	Skip the body of a string literal, which starts just after
+ *		the opening quote, up to but not including the closing
+ *		quote or a newline.
+ */
+
+const char *skipString(const char *p, const char *limit)
+{
+    return kernels.string(p, limit);
+}
@@ -0,0 +1,22 @@
+/*
+ * File:	scanner.h
+ *
+ * Description:	This file contains the function declarations for the
+ *		scanning kernels used by the lexical analyzer for Simple C.
+ *		Each kernel skips over a run of characters that the lexer
+ *		would otherwise have to examine one at a time, and returns
+ *		a pointer to the first character not skipped.  None of them
+ *		ever reads at or beyond the given limit.
+ *
+ *		The kernels are implemented using AVX2, SSE2, or plain C++,
+ *		with the best implementation selected at run time.
+ */
+
+# ifndef SCANNER_H
+# define SCANNER_H
+
+const char *skipSpace(const char *p, const char *limit, int &lines);
+const char *skipComment(const char *p, const char *limit, int &lines);
+const char *skipString(const char *p, const char *limit);
+
+# endif /* SCANNER_H */
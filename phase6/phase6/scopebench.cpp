@@ -0,0 +1,288 @@
+/*
+ * File:	scopebench.cpp
+ *
+ * Description:	This file contains the scaling benchmark for scopes in
+ *		Simple C.
+ *
+ *		First, scopes of growing size are filled with symbols and
+ *		every symbol is then looked up, both in the scope as it is
+ *		now and in a replica of the scope as it used to be, which
+ *		searched its list in order.  The two must find the same
+ *		symbols.  The replica is skipped once it takes too long.
+ *
+ *		Then, programs with growing numbers of declarations per
+ *		scope are generated and compiled in memory through the
+ *		library: globals and function declarations referenced from
+ *		main, the locals of a single function referenced from its
+ *		body, and function declarations that are each replaced by
+ *		a definition.  Every program must compile without errors.
+ *		If scopes scale, the time per declaration stays the same
+ *		as the programs grow.  Each time is the best of several
+ *		runs.
+ *
+ *		usage: scopebench [declarations [runs [seed]]]
+ */
+
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <string>
+# include <vector>
+# include "Scope.h"
+# include "compiler.h"
+
+using namespace std;
+
+static unsigned long state;
+static volatile unsigned long sink;
+
+
+/* The scope as the compiler used to have it */
+
+namespace old {
+
+class Scope {
+    Symbols _symbols;
+
+public:
+    void insert(Symbol *symbol) {
+	_symbols.push_back(symbol);
+    }
+
+    Symbol *find(const Atom &name) const {
+	for (unsigned i = 0; i < _symbols.size(); i ++)
+	    if (name == _symbols[i]->name())
+		return _symbols[i];
+
+	return nullptr;
+    }
+};
+
+}
+
+
+/*
+ * Function:	next (private)
+ *
+ * Description:	Return a pseudo-random number less than the given bound.
+ */
+
+static unsigned next(unsigned bound)
+{
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    return (state >> 33) % bound;
+}
+
+
+/*
+ * Function:	lookups (private)
+ *
+ * Description:	Look up the first given number of symbols in the given
+ *		scope.
+ */
+
+template<class S>
+static unsigned long lookups(const S &scope, const vector<Symbol *> &symbols,
+	unsigned n)
+{
+    unsigned long sum = 0;
+
+
+    for (unsigned i = 0; i < n; i ++)
+	sum += (unsigned long) scope.find(symbols[i]->name());
+
+    return sum;
+}
+
+
+/*
+ * Function:	uses (private)
+ *
+ * Description:	Append statements to the program that refer to random
+ *		names with the given prefix, numbered below the given
+ *		count.  Each name in a function call is called.
+ */
+
+static void uses(string &s, const string &prefix, unsigned count, bool call)
+{
+    for (unsigned i = 0; i < count; i += 8) {
+	s += "    x = x";
+
+	for (unsigned j = 0; j < 8; j ++)
+	    s += " + " + prefix + to_string(next(count)) + (call ? "()" : "");
+
+	s += ";\n";
+    }
+}
+
+
+/*
+ * Function:	globals (private)
+ *
+ * Description:	Return a program declaring the given number of global
+ *		variables and functions, and referring to them from main.
+ */
+
+static string globals(unsigned count)
+{
+    string s;
+
+
+    for (unsigned i = 0; i < count; i ++)
+	s += "int g" + to_string(i) + ", f" + to_string(i) + "();\n";
+
+    s += "int main(void)\n{\n    int x;\n    x = 0;\n";
+    uses(s, "g", count, false);
+    uses(s, "f", count, true);
+    return s + "    return x;\n}\n";
+}
+
+
+/*
+ * Function:	locals (private)
+ *
+ * Description:	Return a program declaring the given number of local
+ *		variables in a single function, and referring to them from
+ *		its body.
+ */
+
+static string locals(unsigned count)
+{
+    string s = "int main(void)\n{\n    int x;\n";
+
+
+    for (unsigned i = 0; i < count; i ++)
+	s += "    int v" + to_string(i) + ";\n";
+
+    s += "    x = 0;\n";
+    uses(s, "v", count, false);
+    return s + "    return x;\n}\n";
+}
+
+
+/*
+ * Function:	definitions (private)
+ *
+ * Description:	Return a program declaring the given number of functions
+ *		and then defining every one of them.
+ */
+
+static string definitions(unsigned count)
+{
+    string s;
+
+
+    for (unsigned i = 0; i < count; i ++)
+	s += "int f" + to_string(i) + "();\n";
+
+    for (unsigned i = 0; i < count; i ++)
+	s += "int f" + to_string(i) + "(void) { return " + to_string(i) + "; }\n";
+
+    return s;
+}
+
+
+/*
+ * Function:	seconds (private)
+ *
+ * Description:	Return the current time in seconds.
+ */
+
+static double seconds()
+{
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/*
+ * Function:	best (private)
+ *
+ * Description:	Return the best time of the given number of runs of the
+ *		given function.
+ */
+
+template<class F>
+static double best(unsigned runs, F f)
+{
+    double start, t, min = 1e30;
+
+
+    for (unsigned i = 0; i < runs; i ++) {
+	start = seconds();
+	sink = f();
+	t = seconds() - start;
+
+	if (t < min)
+	    min = t;
+    }
+
+    return min;
+}
+
+
+int main(int argc, char *argv[])
+{
+    string (*programs[])(unsigned) = {globals, locals, definitions};
+    const char *names[] = {"globals", "locals", "definitions"};
+    unsigned declarations, runs, mismatches = 0, failures = 0;
+    vector<Symbol *> symbols;
+    bool linear = true;
+    string source;
+    double t;
+
+
+    declarations = (argc > 1 ? atoi(argv[1]) : 64000);
+    runs = (argc > 2 ? atoi(argv[2]) : 5);
+    state = (argc > 3 ? strtoul(argv[3], NULL, 0) : 175);
+
+    for (unsigned i = 0; i < declarations; i ++)
+	symbols.push_back(new Symbol(Atom("s" + to_string(i)), Type(intAtom)));
+
+    for (unsigned n = 16; n <= declarations; n *= 4) {
+	Scope scope;
+	old::Scope replica;
+
+	for (unsigned i = 0; i < n; i ++) {
+	    scope.insert(symbols[i]);
+	    replica.insert(symbols[i]);
+	}
+
+	for (unsigned i = 0; i < n; i ++)
+	    if (scope.find(symbols[i]->name()) != replica.find(symbols[i]->name()))
+		mismatches ++;
+
+	t = best(runs, [&] { return lookups(scope, symbols, n); });
+	printf("find %u\thashed\t%.1f ns/lookup", n, t / n * 1e9);
+
+	if (linear) {
+	    t = best(runs, [&] { return lookups(replica, symbols, n); });
+	    printf("\tlinear\t%.1f ns/lookup", t / n * 1e9);
+	    linear = (t < 0.1);
+	}
+
+	printf("\n");
+    }
+
+    for (unsigned i = 0; i < 3; i ++)
+	for (unsigned n = declarations / 16; n <= declarations; n *= 4) {
+	    source = programs[i](n);
+
+	    if (!compile(source).succeeded())
+		failures ++;
+
+	    t = best(runs, [&] { return compile(source).assembly.size(); });
+	    printf("%s %u\t%.3fs\t%.2f us/declaration\n", names[i], n, t, t / n * 1e6);
+	}
+
+    if (mismatches > 0) {
+	printf("%u symbols found differently\n", mismatches);
+	return 1;
+    }
+
+    if (failures > 0) {
+	printf("%u programs compiled incorrectly\n", failures);
+	return 1;
+    }
+
+    return 0;
+}
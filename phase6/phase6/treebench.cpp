@@ -0,0 +1,564 @@
+/*
+ * File:	treebench.cpp
+ *
+ * Description:	This file contains the microbenchmark for traversing
+ *		abstract syntax trees in Simple C.  Of the library, it uses
+ *		only the tree and the modules for its symbols and types.
+ *
+ *		A function body of random statements and expressions is
+ *		built twice from the same seed: once in the node pool that
+ *		the compiler uses now, and once as a replica of the class
+ *		hierarchy that it used to have, in which every node is an
+ *		object with a virtual table and pointers to its children,
+ *		allocated in order from an arena.  Two passes are then run
+ *		over each tree: one that computes the number of registers
+ *		each expression needs, which reads only the kinds and the
+ *		children, and one that also adds up the sizes of the types.
+ *		The replica dispatches with virtual functions and the pool
+ *		with a switch.  The two trees must give the same answers.
+ *		Each time is the best of several runs.
+ *
+ *		usage: treebench [statements [runs [seed]]]
+ */
+
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <vector>
+# include "Tree.h"
+
+using namespace std;
+
+static unsigned long state;
+static vector<Symbol *> variables;
+static volatile unsigned long sink;
+
+
+/* The tree as the compiler used to have it */
+
+namespace old {
+
+class Arena {
+    vector<char *> _blocks;
+    size_t _used;
+
+public:
+    enum { BLOCK_SIZE = 1 << 20 };
+
+    Arena() : _used(BLOCK_SIZE) {}
+
+    ~Arena() {
+	for (unsigned i = 0; i < _blocks.size(); i ++)
+	    delete[] _blocks[i];
+    }
+
+    void *allocate(size_t size) {
+	size = (size + 15) & ~(size_t) 15;
+
+	if (_used + size > BLOCK_SIZE) {
+	    _blocks.push_back(new char[BLOCK_SIZE]);
+	    _used = 0;
+	}
+
+	_used += size;
+	return _blocks.back() + _used - size;
+    }
+
+    size_t bytes() const {
+	return _blocks.size() * BLOCK_SIZE - (BLOCK_SIZE - _used);
+    }
+};
+
+static Arena arena;
+
+class Node {
+protected:
+    Node() : _hasCall(false) {}
+
+public:
+    bool _hasCall;
+
+    virtual ~Node() {}
+
+    static void *operator new(size_t size) { return arena.allocate(size); }
+    static void operator delete(void *) {}
+
+    virtual unsigned label() const = 0;
+    virtual unsigned long size() const = 0;
+};
+
+class Expression : public Node {
+protected:
+    bool _lvalue;
+
+public:
+    unsigned char _need;
+    int _offset;
+    void *_register;
+
+protected:
+    Type _type;
+
+    Expression(const Type &type)
+	: _lvalue(false), _need(1), _offset(0), _register(nullptr), _type(type) {}
+
+public:
+    virtual bool isNumber() const { return false; }
+    virtual bool isIdentifier() const { return false; }
+};
+
+class Identifier : public Expression {
+    Symbol *_symbol;
+
+public:
+    Identifier(Symbol *symbol) : Expression(symbol->type()), _symbol(symbol) {}
+    bool isIdentifier() const { return true; }
+    unsigned label() const { return 1; }
+    unsigned long size() const { return _type.size(); }
+};
+
+class Number : public Expression {
+    unsigned long _value;
+
+public:
+    Number(unsigned long value) : Expression(Type(intAtom)), _value(value) {}
+    bool isNumber() const { return true; }
+    unsigned label() const { return 1; }
+    unsigned long size() const { return _type.size(); }
+};
+
+class Unary : public Expression {
+    Expression *_expr;
+
+public:
+    Unary(Expression *expr, const Type &type) : Expression(type), _expr(expr) {}
+    unsigned label() const { return _expr->label(); }
+    unsigned long size() const { return _type.size() + _expr->size(); }
+};
+
+class Binary : public Expression {
+    Expression *_left, *_right;
+
+public:
+    Binary(Expression *left, Expression *right, const Type &type)
+	: Expression(type), _left(left), _right(right) {}
+
+    unsigned label() const {
+	unsigned left = _left->label(), right = _right->label();
+
+	if (_right->isNumber() || _right->isIdentifier())
+	    right = 0;
+
+	return right == left ? left + 1 : (right > left ? right : left);
+    }
+
+    unsigned long size() const {
+	return _type.size() + _left->size() + _right->size();
+    }
+};
+
+class Statement : public Node {
+};
+
+class Assignment : public Statement {
+    Expression *_left, *_right;
+
+public:
+    Assignment(Expression *left, Expression *right) : _left(left), _right(right) {}
+    unsigned label() const { return _left->label() + _right->label(); }
+    unsigned long size() const { return _left->size() + _right->size(); }
+};
+
+class Return : public Statement {
+    Expression *_expr;
+
+public:
+    Return(Expression *expr) : _expr(expr) {}
+    unsigned label() const { return _expr->label(); }
+    unsigned long size() const { return _expr->size(); }
+};
+
+class Block : public Statement {
+    Scope *_decls;
+    vector<Statement *> _stmts;
+
+public:
+    Block(Scope *decls, const vector<Statement *> &stmts) : _decls(decls), _stmts(stmts) {}
+
+    unsigned label() const {
+	unsigned sum = 0;
+
+	for (unsigned i = 0; i < _stmts.size(); i ++)
+	    sum += _stmts[i]->label();
+
+	return sum;
+    }
+
+    unsigned long size() const {
+	unsigned long sum = 0;
+
+	for (unsigned i = 0; i < _stmts.size(); i ++)
+	    sum += _stmts[i]->size();
+
+	return sum;
+    }
+};
+
+class While : public Statement {
+    Expression *_expr;
+    Statement *_stmt;
+
+public:
+    While(Expression *expr, Statement *stmt) : _expr(expr), _stmt(stmt) {}
+    unsigned label() const { return _expr->label() + _stmt->label(); }
+    unsigned long size() const { return _expr->size() + _stmt->size(); }
+};
+
+class If : public Statement {
+    Expression *_expr;
+    Statement *_thenStmt, *_elseStmt;
+
+public:
+    If(Expression *expr, Statement *thenStmt, Statement *elseStmt)
+	: _expr(expr), _thenStmt(thenStmt), _elseStmt(elseStmt) {}
+
+    unsigned label() const {
+	return _expr->label() + _thenStmt->label() + (_elseStmt ? _elseStmt->label() : 0);
+    }
+
+    unsigned long size() const {
+	return _expr->size() + _thenStmt->size() + (_elseStmt ? _elseStmt->size() : 0);
+    }
+};
+
+}
+
+
+/* A tree built both ways */
+
+struct Pair {
+    old::Node *old;
+    Node node;
+};
+
+
+/*
+ * Function:	next (private)
+ *
+ * Description:	Return the next pseudo-random number below the given bound,
+ *		using the same generator as the identifier corpus.
+ */
+
+static unsigned next(unsigned bound)
+{
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    return (state >> 33) % bound;
+}
+
+
+/*
+ * Function:	expression (private)
+ *
+ * Description:	Build a random expression of at most the given depth.
+ */
+
+static Pair expression(unsigned depth)
+{
+    static const Node::Kind binary[] = {
+	Node::ADD, Node::SUBTRACT, Node::MULTIPLY, Node::LESS_THAN, Node::EQUAL,
+    };
+
+    unsigned choice = next(depth == 0 ? 2 : 9);
+    Pair p, left, right;
+    Symbol *symbol;
+    Node::Kind kind;
+
+
+    if (choice == 0) {
+	symbol = variables[next(variables.size())];
+	p.old = new old::Identifier(symbol);
+	p.node = Node::Identifier(symbol);
+
+    } else if (choice == 1) {
+	unsigned long value = next(1000);
+	p.old = new old::Number(value);
+	p.node = Node::Number(to_string(value));
+
+    } else if (choice == 2) {
+	left = expression(depth - 1);
+	p.old = new old::Unary((old::Expression *) left.old, Type(intAtom));
+	p.node = Node::Unary(Node::NEGATE, left.node, Type(intAtom));
+
+    } else {
+	kind = binary[next(sizeof(binary) / sizeof(binary[0]))];
+	left = expression(depth - 1);
+	right = expression(depth - 1);
+	p.old = new old::Binary((old::Expression *) left.old, (old::Expression *) right.old, Type(intAtom));
+	p.node = Node::Binary(kind, left.node, right.node, Type(intAtom));
+    }
+
+    return p;
+}
+
+
+/*
+ * Function:	block (private)
+ *
+ * Description:	Build a block of the given number of random statements,
+ *		with nested blocks at most the given depth.
+ */
+
+static Pair block(unsigned count, unsigned depth)
+{
+    vector<old::Statement *> olds;
+    Statements stmts;
+    Pair p, expr, stmt, other;
+    Symbol *symbol;
+    Scope *decls;
+
+
+    for (unsigned i = 0; i < count; i ++) {
+	unsigned choice = next(depth == 0 ? 2 : 5);
+
+	if (choice == 0) {
+	    symbol = variables[next(variables.size())];
+	    expr = expression(next(6));
+	    p.old = new old::Assignment(new old::Identifier(symbol), (old::Expression *) expr.old);
+	    p.node = Node::Assignment(Node::Identifier(symbol), expr.node);
+
+	} else if (choice == 1) {
+	    expr = expression(next(6));
+	    p.old = new old::Return((old::Expression *) expr.old);
+	    p.node = Node::Return(expr.node);
+
+	} else if (choice == 2) {
+	    expr = expression(2);
+	    stmt = block(1 + next(4), depth - 1);
+	    p.old = new old::While((old::Expression *) expr.old, (old::Statement *) stmt.old);
+	    p.node = Node::While(expr.node, stmt.node);
+
+	} else {
+	    expr = expression(2);
+	    stmt = block(1 + next(4), depth - 1);
+
+	    if (choice == 3) {
+		other = block(1 + next(4), depth - 1);
+		p.old = new old::If((old::Expression *) expr.old, (old::Statement *) stmt.old, (old::Statement *) other.old);
+		p.node = Node::If(expr.node, stmt.node, other.node);
+	    } else {
+		p.old = new old::If((old::Expression *) expr.old, (old::Statement *) stmt.old, nullptr);
+		p.node = Node::If(expr.node, stmt.node, Node());
+	    }
+	}
+
+	olds.push_back((old::Statement *) p.old);
+	stmts.push_back(p.node);
+    }
+
+    decls = new Scope();
+    p.old = new old::Block(decls, olds);
+    p.node = Node::Block(decls, stmts);
+    return p;
+}
+
+
+/*
+ * Function:	label (private)
+ *
+ * Description:	Compute the number of registers needed by the expressions
+ *		of a tree in the pool, as old::Node::label does for the
+ *		replica.
+ */
+
+static unsigned label(Node node)
+{
+    unsigned left, right, sum;
+
+
+    switch (node.kind()) {
+    case Node::IDENTIFIER:
+    case Node::NUMBER:
+	return 1;
+
+    case Node::NEGATE:
+    case Node::RETURN:
+	return label(node.expr());
+
+    case Node::ADD:
+    case Node::SUBTRACT:
+    case Node::MULTIPLY:
+    case Node::LESS_THAN:
+    case Node::EQUAL:
+	left = label(node.left());
+	right = label(node.right());
+
+	if (node.right().kind() == Node::NUMBER || node.right().kind() == Node::IDENTIFIER)
+	    right = 0;
+
+	return right == left ? left + 1 : (right > left ? right : left);
+
+    case Node::ASSIGNMENT:
+	return label(node.left()) + label(node.right());
+
+    case Node::BLOCK:
+	sum = 0;
+
+	for (unsigned i = 0; i < node.count(); i ++)
+	    sum += label(node.child(i));
+
+	return sum;
+
+    case Node::WHILE:
+	return label(node.expr()) + label(node.stmt());
+
+    case Node::IF:
+	sum = label(node.expr()) + label(node.thenStmt());
+	return node.elseStmt() ? sum + label(node.elseStmt()) : sum;
+
+    default:
+	return 0;
+    }
+}
+
+
+/*
+ * Function:	size (private)
+ *
+ * Description:	Add up the sizes of the types of the expressions of a tree
+ *		in the pool, as old::Node::size does for the replica.
+ */
+
+static unsigned long size(Node node)
+{
+    unsigned long sum;
+
+
+    switch (node.kind()) {
+    case Node::IDENTIFIER:
+    case Node::NUMBER:
+	return node.type().size();
+
+    case Node::NEGATE:
+	return node.type().size() + size(node.expr());
+
+    case Node::RETURN:
+	return size(node.expr());
+
+    case Node::ADD:
+    case Node::SUBTRACT:
+    case Node::MULTIPLY:
+    case Node::LESS_THAN:
+    case Node::EQUAL:
+	return node.type().size() + size(node.left()) + size(node.right());
+
+    case Node::ASSIGNMENT:
+	return size(node.left()) + size(node.right());
+
+    case Node::BLOCK:
+	sum = 0;
+
+	for (unsigned i = 0; i < node.count(); i ++)
+	    sum += size(node.child(i));
+
+	return sum;
+
+    case Node::WHILE:
+	return size(node.expr()) + size(node.stmt());
+
+    case Node::IF:
+	sum = size(node.expr()) + size(node.thenStmt());
+	return node.elseStmt() ? sum + size(node.elseStmt()) : sum;
+
+    default:
+	return 0;
+    }
+}
+
+
+/*
+ * Function:	seconds (private)
+ *
+ * Description:	Return the current time in seconds.
+ */
+
+static double seconds()
+{
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/*
+ * Function:	best (private)
+ *
+ * Description:	Return the best time of the given number of runs of the
+ *		given function.
+ */
+
+template<class F>
+static double best(unsigned runs, F f)
+{
+    double start, t, min = 1e30;
+
+
+    for (unsigned i = 0; i < runs; i ++) {
+	start = seconds();
+	sink = f();
+	t = seconds() - start;
+
+	if (t < min)
+	    min = t;
+    }
+
+    return min;
+}
+
+
+int main(int argc, char *argv[])
+{
+    unsigned statements, runs, mismatches = 0;
+    size_t count, bytes;
+    double t;
+    Pair tree;
+
+
+    statements = (argc > 1 ? atoi(argv[1]) : 20000);
+    runs = (argc > 2 ? atoi(argv[2]) : 5);
+    state = (argc > 3 ? strtoul(argv[3], NULL, 0) : 175);
+
+    for (unsigned i = 0; i < 16; i ++)
+	variables.push_back(new Symbol(Atom("v" + to_string(i)), Type(i % 4 ? intAtom : longAtom)));
+
+    tree = block(statements, 4);
+    count = pool->records.size() - 1;
+
+    bytes = sizeof(NodePool::Record) * pool->records.size() + sizeof(Node) * pool->lists.size();
+    printf("%lu nodes in %lu statements\n", count, (unsigned long) statements);
+    printf("virtual nodes\t%.1f bytes/node\n", (double) old::arena.bytes() / count);
+    printf("node pool\t%.1f bytes/node, %.1f with types\n", (double) bytes / count,
+	    (double) (bytes + sizeof(Type) * pool->types.size()) / count);
+
+    if (tree.old->label() != label(tree.node))
+	mismatches ++;
+
+    if (tree.old->size() != size(tree.node))
+	mismatches ++;
+
+    t = best(runs, [&] { return tree.old->label(); });
+    printf("need, virtual\t%.3fs\t%.2f ns/node\n", t, t / count * 1e9);
+
+    t = best(runs, [&] { return label(tree.node); });
+    printf("need, pool\t%.3fs\t%.2f ns/node\n", t, t / count * 1e9);
+
+    t = best(runs, [&] { return tree.old->size(); });
+    printf("size, virtual\t%.3fs\t%.2f ns/node\n", t, t / count * 1e9);
+
+    t = best(runs, [&] { return size(tree.node); });
+    printf("size, pool\t%.3fs\t%.2f ns/node\n", t, t / count * 1e9);
+
+    if (mismatches > 0) {
+	printf("%u passes computed differently\n", mismatches);
+	return 1;
+    }
+
+    return 0;
+}
@@ -8,9 +8,7 @@
  *
  *		This functionality has no end purpose in the actual
  *		compiler.  However, it is useful in understanding the
- *		structure of the abstract syntax tree, and is also a
- *		refresher on how to write and use polymorphic virtual
- *		functions in C++.
+ *		structure of the abstract syntax tree.
  */
 
 # include "Tree.h"
@@ -28,189 +26,139 @@ using namespace std;
  *		something else and we don't want ours to get in the way.
  */
 
-static ostream &operator <<(ostream &ostr, const Node *node)
+static ostream &operator <<(ostream &ostr, Node node)
 {
-    node->write(ostr);
+    node.write(ostr);
     return ostr;
 }
 
 
 /*
- * From this point on are the member functions for printing the tree, one
- * for each type of tree node that can be instantiated.  If you really,
- * really want a function comment header for each one, write them yourself.
+ * Function:	binary (private)
+ *
+ * Description:	Return the operator of a binary node as it is written.
  */
 
-void String::write(ostream &ostr) const
-{
-    ostr << _value;
-}
-
-void Identifier::write(ostream &ostr) const
-{
-    ostr << _symbol->name();
-}
-
-void Number::write(ostream &ostr) const
-{
-    ostr << _value << (_type.specifier() == "long" ? "L" : "");
-}
-
-void Call::write(ostream &ostr) const
-{
-    ostr << "(" << _id->name();
-
-    for (unsigned i = 0; i < _args.size(); i ++)
-	ostr << " " << _args[i];
-
-    ostr << ")";
-}
-
-void Field::write(ostream &ostr) const
-{
-    ostr << "(. " << _expr << " " << _id->name() << ")";
-}
-
-void Not::write(ostream &ostr) const
+static const char *binary(Node::Kind kind)
 {
-    ostr << "(! " << _expr << ")";
-}
+    static const char *operators[] = {
+	"*", "/", "%", "+", "-", "<", ">", "<=", ">=", "==", "!=", "&&", "||",
+    };
 
-void Negate::write(ostream &ostr) const
-{
-    ostr << "(- " << _expr << ")";
+    return operators[kind - Node::MULTIPLY];
 }
 
-void Dereference::write(ostream &ostr) const
-{
-    ostr << "(* " << _expr << ")";
-}
 
-void Address::write(ostream &ostr) const
-{
-    ostr << "(& " << _expr << ")";
-}
-
-void Cast::write(ostream &ostr) const
-{
-    ostr << "(" << _type << " " << _expr << ")";
-}
+/*
+ * Function:	Node::write
+ *
+ * Description:	Write this node and its children.  If you really, really
+ *		want a function comment header for each kind of node,
+ *		write them yourself.
+ */
 
-void Multiply::write(ostream &ostr) const
+void Node::write(ostream &ostr) const
 {
-    ostr << "(* " << _left << " " << _right << ")";
-}
+    switch (kind()) {
+    case STRING:
+	ostr << text();
+	break;
 
-void Divide::write(ostream &ostr) const
-{
-    ostr << "(/ " << _left << " " << _right << ")";
-}
+    case IDENTIFIER:
+	ostr << symbol()->name();
+	break;
 
-void Remainder::write(ostream &ostr) const
-{
-    ostr << "(% " << _left << " " << _right << ")";
-}
+    case NUMBER:
+	ostr << value() << (type().specifier() == longAtom ? "L" : "");
+	break;
 
-void Add::write(ostream &ostr) const
-{
-    ostr << "(+ " << _left << " " << _right << ")";
-}
+    case CALL:
+	ostr << "(" << symbol()->name();
 
-void Subtract::write(ostream &ostr) const
-{
-    ostr << "(- " << _left << " " << _right << ")";
-}
+	for (unsigned i = 0; i < count(); i ++)
+	    ostr << " " << child(i);
 
-void LessThan::write(ostream &ostr) const
-{
-    ostr << "(< " << _left << " " << _right << ")";
-}
+	ostr << ")";
+	break;
 
-void GreaterThan::write(ostream &ostr) const
-{
-    ostr << "(> " << _left << " " << _right << ")";
-}
+    case FIELD:
+	ostr << "(. " << expr() << " " << symbol()->name() << ")";
+	break;
 
-void LessOrEqual::write(ostream &ostr) const
-{
-    ostr << "(<= " << _left << " " << _right << ")";
-}
+    case NOT:
+	ostr << "(! " << expr() << ")";
+	break;
 
-void GreaterOrEqual::write(ostream &ostr) const
-{
-    ostr << "(>= " << _left << " " << _right << ")";
-}
+    case NEGATE:
+	ostr << "(- " << expr() << ")";
+	break;
 
-void Equal::write(ostream &ostr) const
-{
-    ostr << "(== " << _left << " " << _right << ")";
-}
+    case DEREFERENCE:
+	ostr << "(* " << expr() << ")";
+	break;
 
-void NotEqual::write(ostream &ostr) const
-{
-    ostr << "(!= " << _left << " " << _right << ")";
-}
+    case ADDRESS:
+	ostr << "(& " << expr() << ")";
+	break;
 
-void LogicalAnd::write(ostream &ostr) const
-{
-    ostr << "(&& " << _left << " " << _right << ")";
-}
+    case CAST:
+	ostr << "(" << type() << " " << expr() << ")";
+	break;
 
-void LogicalOr::write(ostream &ostr) const
-{
-    ostr << "(|| " << _left << " " << _right << ")";
-}
+    case MULTIPLY: case DIVIDE: case REMAINDER: case ADD: case SUBTRACT:
+    case LESS_THAN: case GREATER_THAN: case LESS_OR_EQUAL:
+    case GREATER_OR_EQUAL: case EQUAL: case NOT_EQUAL:
+    case LOGICAL_AND: case LOGICAL_OR:
+	ostr << "(" << binary(kind()) << " " << left() << " " << right() << ")";
+	break;
 
-void Assignment::write(ostream &ostr) const
-{
-    ostr << "(= " << _left << " " << _right << ")";
-}
+    case ASSIGNMENT:
+	ostr << "(= " << left() << " " << right() << ")";
+	break;
 
-void Return::write(ostream &ostr) const
-{
-    ostr << "(return " << _expr << ")";
-}
+    case RETURN:
+	ostr << "(return " << expr() << ")";
+	break;
 
-void Block::write(ostream &ostr) const
-{
-    ostr << "(begin";
+    case BLOCK:
+	ostr << "(begin";
 
-    for (unsigned i = 0; i < _stmts.size(); i ++)
-	ostr << " " << _stmts[i];
+	for (unsigned i = 0; i < count(); i ++)
+	    ostr << " " << child(i);
 
-    ostr << ")";
-}
+	ostr << ")";
+	break;
 
-void While::write(ostream &ostr) const
-{
-    ostr << "(while " << _expr << " " << _stmt << ")";
-}
+    case WHILE:
+	ostr << "(while " << expr() << " " << stmt() << ")";
+	break;
 
-void If::write(ostream &ostr) const
-{
-    ostr << "(if " << _expr << " " << _thenStmt;
+    case IF:
+	ostr << "(if " << expr() << " " << thenStmt();
 
-    if (_elseStmt != nullptr)
-	ostr << " " << _elseStmt;
+	if (elseStmt())
+	    ostr << " " << elseStmt();
 
-    ostr << ")";
-}
+	ostr << ")";
+	break;
 
-void Simple::write(ostream &ostr) const
-{
-    ostr << _expr;
-}
+    case SIMPLE:
+	ostr << expr();
+	break;
 
-void Function::write(ostream &ostr) const
-{
-    unsigned num = _id->type().parameters()->size();
-    const Symbols &symbols = _body->declarations()->symbols();
+    case FUNCTION:
+	{
+	    unsigned num = symbol()->type().parameters()->size();
+	    const Symbols &symbols = body().declarations()->symbols();
 
+	    ostr << "(define " << (num > 0 ? "(" : "") << symbol()->name();
 
-    ostr << "(define " << (num > 0 ? "(" : "") << _id->name();
+	    for (unsigned i = 0; i < num; i ++)
+		ostr << " " << symbols[i]->name();
 
-    for (unsigned i = 0; i < num; i ++)
-	ostr << " " << symbols[i]->name();
+	    ostr << (num > 0 ? ") " : " ") << body() << ")";
+	}
 
-    ostr << (num > 0 ? ") " : " ") << _body << ")";
+	break;
+    }
 }